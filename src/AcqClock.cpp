@@ -0,0 +1,80 @@
+// ============================================================
+//  Protek506Logger — AcqClock.cpp
+// ============================================================
+#include "AcqClock.h"
+#include <chrono>
+
+int64_t AcqClock::NowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ----------------------------------------------------------------
+// Anchor
+// ----------------------------------------------------------------
+void AcqClock::AnchorNow()
+{
+    // The system clock read is bracketed by two steady reads and paired
+    // with their midpoint, so a preemption between the reads costs at
+    // most half its length.
+    using namespace std::chrono;
+    int64_t before = NowUs();
+    int64_t wallUs = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    int64_t after  = NowUs();
+    Anchor(wallUs, before + (after - before) / 2);
+}
+
+void AcqClock::Anchor(int64_t wallUs, int64_t monoUs)
+{
+    m_wallAnchorUs = wallUs;
+    m_monoAnchorUs = monoUs;
+}
+
+// ----------------------------------------------------------------
+// Replies
+// ----------------------------------------------------------------
+void AcqClock::Trigger(int64_t monoUs)
+{
+    m_triggerUs = monoUs;
+    m_haveFirst = false;
+}
+
+void AcqClock::Received(int64_t monoUs, size_t len)
+{
+    m_spanUs  = monoUs;
+    m_spanLen = len;
+    if (!m_haveFirst)
+    {
+        m_firstUs   = monoUs - static_cast<int64_t>(len) * kCharUs;
+        m_haveFirst = true;
+    }
+}
+
+void AcqClock::Stamp(DmmSample& s, size_t crOffset)
+{
+    // Latest the CR can have ended, then back over the line before it
+    int64_t tail  = static_cast<int64_t>(m_spanLen - 1 - crOffset);
+    int64_t start = m_spanUs - tail * kCharUs - (s.rawLen + 1) * kCharUs;
+
+    // The first span may have arrived late in a bigger piece (a USB
+    // adapter's latency timer); it may also prove an earlier start.
+    if (m_haveFirst && m_firstUs < start) start = m_firstUs;
+
+    // Not before the trigger, nor before the previous reading
+    if (start < m_triggerUs) start = m_triggerUs;
+    if (start < m_lastUs)    start = m_lastUs;
+
+    s.monoUs    = start;
+    s.wallUs    = WallUs(start);
+    s.triggerUs = m_triggerUs;
+    s.rxUs      = m_spanUs;
+
+    m_lastUs    = start;
+    m_haveFirst = false;        // the rest of the span is the next reply
+}
+
+void AcqClock::Reset()
+{
+    m_haveFirst = false;
+}
@@ -0,0 +1,77 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — AcqClock.h
+//  Acquisition timestamps for one meter's replies.
+//
+//  A reading used to be stamped when its CR had been parsed,
+//  but at 1200 baud 7N2 a character takes 8.33 ms, so a reply
+//  spends ~110 ms on the wire and the CR-time stamp lagged the
+//  measurement by an amount that varied with the line length.
+//
+//  AcqClock instead dates each reading at the start of its
+//  first byte on the wire.  Every span of bytes taken from the
+//  port is timed as it arrives; a span of n bytes read at t
+//  cannot have started later than t - n character times, and
+//  the CR at offset k of a span can have ended no later than
+//  t - (n - 1 - k) character times.  The earliest of these
+//  bounds, less the line's own length, is the reply's start,
+//  clamped to the trigger that asked for it (and to the
+//  previous reading, so timestamps never run backwards).
+//
+//  Wall-clock time is not read per reading.  The steady clock
+//  is anchored to the system clock once per connection, and
+//  wallUs = monoUs + offset, so date and time always agree, a
+//  clock step mid-run cannot reorder readings, and the binary
+//  log and raw captures can carry the same anchor.
+//
+//  Not thread-safe: one per port, used by the thread that
+//  reads that port (or by ReplaySource, fed the recorded
+//  trigger and receive times, which stamps identically).
+// ============================================================
+#include <cstddef>
+#include <cstdint>
+#include "DmmParser.h"
+
+class AcqClock
+{
+public:
+    // One character at 1200 baud 7N2: start + 7 data + 2 stop bits
+    static constexpr int64_t kCharUs = 10 * 1000000 / 1200;
+
+    // Tie the steady clock to the system clock.  AnchorNow() reads
+    // both; Anchor() takes a recorded pair (a capture's session).
+    void AnchorNow();
+    void Anchor(int64_t wallUs, int64_t monoUs);
+    int64_t WallAnchorUs() const { return m_wallAnchorUs; }
+    int64_t MonoAnchorUs() const { return m_monoAnchorUs; }
+
+    // A steady-clock time on the wall clock
+    int64_t WallUs(int64_t monoUs) const { return monoUs + (m_wallAnchorUs - m_monoAnchorUs); }
+
+    // The trigger went out at monoUs; a new reply is due.
+    void Trigger(int64_t monoUs);
+
+    // 'len' bytes were taken from the port at monoUs.  Call before
+    // feeding them to the parser.
+    void Received(int64_t monoUs, size_t len);
+
+    // In the parser's callback: fill in s.monoUs, wallUs, triggerUs and
+    // rxUs for the reading whose CR is byte 'crOffset' of the last span.
+    void Stamp(DmmSample& s, size_t crOffset);
+
+    // The reply in progress was abandoned (read timeout, reconnect).
+    void Reset();
+
+    // steady_clock µs, the clock of DmmSample::monoUs
+    static int64_t NowUs();
+
+private:
+    int64_t m_wallAnchorUs = 0;
+    int64_t m_monoAnchorUs = 0;
+    int64_t m_triggerUs    = 0;     // last trigger; 0 if none
+    int64_t m_spanUs       = 0;     // arrival of the last span ...
+    size_t  m_spanLen      = 0;     // ... and its length
+    int64_t m_firstUs      = 0;     // latest start of the reply's first span
+    bool    m_haveFirst    = false;
+    int64_t m_lastUs       = 0;     // last reading's start
+};
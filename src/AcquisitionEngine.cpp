@@ -0,0 +1,399 @@
+// ============================================================
+//  Protek506Logger — AcquisitionEngine.cpp
+// ============================================================
+#include "AcquisitionEngine.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+// Tags stored in epoll_event.data.u64 for the two internal descriptors.
+// Port events carry the port id, which is always >= 1.
+static const uint64_t TAG_TIMER = 0;
+static const uint64_t TAG_WAKE  = UINT64_MAX;
+
+// A meter that has not finished its reply this long after the trigger is
+// treated the same way MeterPoller treats a read timeout.
+static const int64_t  REPLY_TIMEOUT_NS = 1000LL * 1000 * 1000;
+
+// ----------------------------------------------------------------
+// Constructor / Destructor
+// ----------------------------------------------------------------
+AcquisitionEngine::AcquisitionEngine() {}
+
+AcquisitionEngine::~AcquisitionEngine()
+{
+    Stop();
+}
+
+int64_t AcquisitionEngine::NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+std::string AcquisitionEngine::LastError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+AcquisitionEngine::PortCounters AcquisitionEngine::Counters(int portId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_counters.find(portId);
+    return it != m_counters.end() ? it->second : PortCounters();
+}
+
+// ----------------------------------------------------------------
+// Start / Stop
+// ----------------------------------------------------------------
+bool AcquisitionEngine::Start()
+{
+    if (IsRunning()) return true;
+
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    m_wakeFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_timerFd < 0 || m_wakeFd < 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = std::string("engine setup failed: ") + strerror(errno);
+        Stop();
+        return false;
+    }
+
+    struct epoll_event ev = {};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = TAG_TIMER;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_timerFd, &ev);
+    ev.data.u64 = TAG_WAKE;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = false;
+        m_counters.clear();
+    }
+    m_stop   = false;
+    m_thread = std::thread(&AcquisitionEngine::Run, this);
+    return true;
+}
+
+void AcquisitionEngine::Stop()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopRequested = true;
+        }
+        Wake();
+        m_thread.join();
+    }
+
+    // The counters stay readable until the next Start()
+    m_ports.clear();            // SerialPort destructors close the fds
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commands.clear();
+    }
+    if (m_epollFd >= 0) { ::close(m_epollFd); m_epollFd = -1; }
+    if (m_timerFd >= 0) { ::close(m_timerFd); m_timerFd = -1; }
+    if (m_wakeFd  >= 0) { ::close(m_wakeFd);  m_wakeFd  = -1; }
+}
+
+void AcquisitionEngine::Wake()
+{
+    if (m_wakeFd < 0) return;
+    uint64_t one = 1;
+    ssize_t n = ::write(m_wakeFd, &one, sizeof(one));
+    (void)n;   // EAGAIN only if the counter is already non-zero
+}
+
+// ----------------------------------------------------------------
+// Port management (any thread)
+// ----------------------------------------------------------------
+int AcquisitionEngine::AddPort(const std::string& device, int pollDelayMs,
+                               const std::string& capturePath)
+{
+    std::unique_ptr<Port> p(new Port);
+    p->device = device;
+    p->exchange.SetLatencyStats(m_latency);
+    if (!capturePath.empty() && !p->exchange.StartCapture(capturePath))
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = p->exchange.CaptureError();
+        return -1;
+    }
+    if (!p->serial.Open(device, 1200, 7, 2, 'N', 1000))
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = "Cannot open port " + device + ": " + p->serial.LastError();
+        return -1;
+    }
+    p->periodNs = static_cast<int64_t>(pollDelayMs > 0 ? pollDelayMs : 1) * 1000000LL;
+
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id    = m_nextId++;
+        p->id = id;
+        p->exchange.SetReadingHandler([this, id](DmmSample& s) {
+            if (m_onReading)
+                m_onReading(id, s);
+        });
+        Command c;
+        c.add = std::move(p);
+        m_commands.push_back(std::move(c));
+    }
+    Wake();
+    return id;
+}
+
+void AcquisitionEngine::RemovePort(int portId)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters.erase(portId);
+        Command c;
+        c.removeId = portId;
+        m_commands.push_back(std::move(c));
+    }
+    Wake();
+}
+
+// ----------------------------------------------------------------
+// Engine thread
+// ----------------------------------------------------------------
+void AcquisitionEngine::ApplyCommands()
+{
+    std::vector<Command> cmds;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        cmds.swap(m_commands);
+        m_stop = m_stopRequested;
+    }
+
+    int64_t now = NowNs();
+    for (auto& c : cmds)
+    {
+        if (c.add)
+        {
+            Port* p = c.add.get();
+            struct epoll_event ev = {};
+            ev.events   = EPOLLIN;
+            ev.data.u64 = static_cast<uint64_t>(p->id);
+            if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, p->serial.Fd(), &ev) != 0)
+            {
+                if (m_onError)
+                    m_onError(p->id, std::string("epoll_ctl failed: ") + strerror(errno));
+                continue;
+            }
+            p->nextTrigger = now;       // first trigger right away
+            p->exchange.Connected();
+            m_ports[p->id] = std::move(c.add);
+        }
+        else
+        {
+            {
+                // Published again if the port was polled meanwhile
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_counters.erase(c.removeId);
+            }
+            auto it = m_ports.find(c.removeId);
+            if (it == m_ports.end()) continue;
+            epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it->second->serial.Fd(), nullptr);
+            m_ports.erase(it);
+        }
+    }
+}
+
+void AcquisitionEngine::ArmTimer()
+{
+    struct itimerspec its = {};
+    if (!m_ports.empty())
+    {
+        int64_t next = INT64_MAX;
+        for (auto& kv : m_ports)
+            if (kv.second->nextTrigger < next)
+                next = kv.second->nextTrigger;
+        if (next < 1) next = 1;         // all-zero it_value would disarm
+        its.it_value.tv_sec  = static_cast<time_t>(next / 1000000000LL);
+        its.it_value.tv_nsec = static_cast<long>(next % 1000000000LL);
+    }
+    timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &its, nullptr);
+}
+
+void AcquisitionEngine::TriggerDue(int64_t now)
+{
+    std::vector<std::pair<int, std::string>> failed;
+
+    for (auto& kv : m_ports)
+    {
+        Port& p = *kv.second;
+
+        if (p.sentAt != 0 && now - p.sentAt >= REPLY_TIMEOUT_NS)
+        {
+            // Meter went quiet mid-line (or never answered): drop the
+            // fragment so it cannot prefix the next reply.
+            p.serial.DiscardInput();
+            p.exchange.Abandon();
+            p.sentAt = 0;
+        }
+
+        if (p.nextTrigger > now) continue;
+
+        // Absolute schedule: advance by whole periods so a slow reply
+        // delays at most one trigger instead of shifting all later ones.
+        // Every slot passed without a trigger counts as missed, as in
+        // PollScheduler.
+        uint64_t slots = 0;
+        while (p.nextTrigger <= now)
+        {
+            p.nextTrigger += p.periodNs;
+            ++slots;
+        }
+
+        // One outstanding request per meter; skip this slot while the
+        // previous reply is still arriving.
+        if (p.sentAt != 0)
+        {
+            p.missed += slots;
+            Publish(p);
+            continue;
+        }
+        p.missed += slots - 1;
+
+        static const uint8_t trigger = '\n';
+        if (p.serial.WriteByte(trigger) < 0)
+        {
+            failed.emplace_back(p.id, "Serial write error: " + p.serial.LastError());
+            continue;
+        }
+        p.sentAt = now;
+        p.exchange.Triggered(AcqClock::NowUs(), trigger);
+        Publish(p);
+    }
+
+    for (auto& f : failed)
+        DropPort(f.first, f.second);
+}
+
+void AcquisitionEngine::ServicePort(Port& p, uint32_t events)
+{
+    int n = p.serial.ReadAvailable();
+    if (n < 0)
+    {
+        DropPort(p.id, "Serial read error: " + p.serial.LastError());
+        return;
+    }
+    if (n == 0 && (events & (EPOLLHUP | EPOLLERR)))
+    {
+        DropPort(p.id, "Serial port closed (device removed?)");
+        return;
+    }
+
+    // Parse straight out of the receive ring; the callback runs the
+    // moment a reading's CR is seen.
+    size_t len = 0;
+    const uint8_t* data;
+    while ((data = p.serial.PeekInput(len)), len > 0)
+    {
+        p.exchange.Received(data, len, AcqClock::NowUs());
+        p.serial.ConsumeInput(len);
+    }
+
+    // A garbled reply ends the exchange as well as a reading.
+    if (p.exchange.ReplyEnded())
+        p.sentAt = 0;
+    Publish(p);
+}
+
+void AcquisitionEngine::Publish(Port& p)
+{
+    PortCounters c;
+    c.missed        = p.missed;
+    c.garbled       = p.exchange.GarbledFrames();
+    c.captureBytes  = p.exchange.CaptureBytes();
+    c.captureFailed = p.exchange.CaptureFailed();
+    if (c.missed == p.published.missed && c.garbled == p.published.garbled &&
+        c.captureBytes == p.published.captureBytes && c.captureFailed == p.published.captureFailed)
+        return;
+    p.published = c;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[p.id] = c;
+}
+
+void AcquisitionEngine::DropPort(int portId, const std::string& error)
+{
+    auto it = m_ports.find(portId);
+    if (it == m_ports.end()) return;
+    Publish(*it->second);       // final counts, kept until RemovePort()
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it->second->serial.Fd(), nullptr);
+    m_ports.erase(it);
+    if (m_onError)
+        m_onError(portId, error);
+}
+
+void AcquisitionEngine::Run()
+{
+    const int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+
+    ApplyCommands();
+    ArmTimer();
+
+    while (!m_stop)
+    {
+        int n = epoll_wait(m_epollFd, events, MAX_EVENTS, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            if (m_onError)
+                m_onError(-1, std::string("epoll_wait failed: ") + strerror(errno));
+            break;
+        }
+
+        bool timerFired = false;
+        bool woken      = false;
+        for (int i = 0; i < n; ++i)
+        {
+            uint64_t tag = events[i].data.u64;
+            if (tag == TAG_TIMER)
+            {
+                uint64_t expirations;
+                ssize_t r = ::read(m_timerFd, &expirations, sizeof(expirations));
+                (void)r;
+                timerFired = true;
+            }
+            else if (tag == TAG_WAKE)
+            {
+                uint64_t count;
+                ssize_t r = ::read(m_wakeFd, &count, sizeof(count));
+                (void)r;
+                woken = true;
+            }
+            else
+            {
+                // A port dropped earlier in this batch is simply skipped.
+                auto it = m_ports.find(static_cast<int>(tag));
+                if (it != m_ports.end())
+                    ServicePort(*it->second, events[i].events);
+            }
+        }
+
+        if (woken)
+            ApplyCommands();
+        if (timerFired || woken)
+        {
+            TriggerDue(NowNs());
+            ArmTimer();
+        }
+    }
+}
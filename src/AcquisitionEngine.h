@@ -0,0 +1,139 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — AcquisitionEngine.h
+//  Single-thread, epoll-driven poller for many Protek 506s at
+//  once (Linux only).
+//
+//  MeterPoller dedicates one thread to one meter.  The engine
+//  instead owns N SerialPorts and multiplexes them from one
+//  thread:
+//    - one timerfd, armed at the earliest pending trigger,
+//      sends each meter its '\n' on its own schedule;
+//    - each port fd is registered with epoll, and input is
+//      block-read into the port's receive ring as it arrives;
+//    - the bytes go from the ring through that port's
+//      MeterExchange, the same parsing, timestamps, raw capture
+//      and latency stages as MeterPoller's, and each reading is
+//      handed to the reading callback as soon as its CR arrives.
+//
+//  The headless daemon (tools/protek506d) runs on it.  Ports may
+//  be added and removed while the engine runs; both calls are
+//  thread-safe and wake the loop through an eventfd.  Callbacks
+//  are invoked on the engine thread and must not block for
+//  long — every meter shares that thread.
+// ============================================================
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SerialPort.h"
+#include "MeterExchange.h"
+
+class AcquisitionEngine
+{
+public:
+    using ReadingHandler = std::function<void(int portId, const DmmSample& s)>;
+    using ErrorHandler   = std::function<void(int portId, const std::string& msg)>;
+
+    // A port's counters, as last published by the engine thread
+    struct PortCounters
+    {
+        uint64_t missed       = 0;      // trigger slots skipped: reply still pending
+        uint64_t garbled      = 0;      // replies discarded as garbled
+        uint64_t captureBytes = 0;      // raw capture size
+        bool     captureFailed = false;
+    };
+
+    AcquisitionEngine();
+    ~AcquisitionEngine();
+
+    AcquisitionEngine(const AcquisitionEngine&) = delete;
+    AcquisitionEngine& operator=(const AcquisitionEngine&) = delete;
+
+    // Set the handlers before Start(); they are not synchronised.
+    void SetReadingHandler(ReadingHandler fn) { m_onReading = std::move(fn); }
+    void SetErrorHandler(ErrorHandler fn)     { m_onError   = std::move(fn); }
+
+    // Record every port's Reply and Receive stages into 'stats' (may be
+    // null; must outlive the engine).  Set before Start().  The engine
+    // thread is the single writer, as LatencyStats requires.
+    void SetLatencyStats(LatencyStats* stats) { m_latency = stats; }
+
+    // Start / stop the engine thread.  Stop() closes every port.
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Open 'device' (1200 baud 7N2) and schedule it for polling every
+    // pollDelayMs, recording its traffic to capturePath if one is given
+    // (see RawCapture.h).  Returns the port id, or -1 with LastError()
+    // set.  Safe to call from any thread, before or after Start().
+    int  AddPort(const std::string& device, int pollDelayMs = 200,
+                 const std::string& capturePath = std::string());
+
+    // Close and forget a port.  Takes effect on the next loop pass;
+    // no callbacks for this id are made after that.  A port the engine
+    // dropped after an error (see SetErrorHandler) keeps its counters
+    // until it is removed.
+    void RemovePort(int portId);
+
+    std::string LastError() const;
+
+    // Counters of a port (any thread); zero for an unknown id.
+    PortCounters Counters(int portId) const;
+
+private:
+    struct Port
+    {
+        int         id           = -1;
+        std::string device;
+        SerialPort  serial;
+        MeterExchange exchange;
+        int64_t     periodNs     = 0;
+        int64_t     nextTrigger  = 0;   // CLOCK_MONOTONIC, ns
+        int64_t     sentAt       = 0;   // last trigger, 0 = no reply pending
+        uint64_t    missed       = 0;   // see PortCounters
+        PortCounters published;         // as last copied to m_counters
+    };
+
+    struct Command
+    {
+        std::unique_ptr<Port> add;      // non-null: add this port
+        int                   removeId = -1;
+    };
+
+    void Run();
+    void ApplyCommands();
+    void ArmTimer();
+    void TriggerDue(int64_t now);
+    void ServicePort(Port& p, uint32_t events);
+    void DropPort(int portId, const std::string& error);
+    void Publish(Port& p);
+    void Wake();
+
+    static int64_t NowNs();
+
+    int m_epollFd = -1;
+    int m_timerFd = -1;
+    int m_wakeFd  = -1;
+
+    std::thread             m_thread;
+    bool                    m_stop = false;        // engine thread only
+
+    std::map<int, std::unique_ptr<Port>> m_ports;  // engine thread only
+
+    mutable std::mutex      m_mutex;               // guards the fields below
+    std::vector<Command>    m_commands;
+    bool                    m_stopRequested = false;
+    int                     m_nextId        = 1;
+    std::string             m_lastError;
+    std::map<int, PortCounters> m_counters;        // published per port
+
+    ReadingHandler          m_onReading;
+    ErrorHandler            m_onError;
+    LatencyStats*           m_latency = nullptr;
+};
@@ -0,0 +1,344 @@
+// ============================================================
+//  Protek506Logger — AlarmEngine.cpp
+// ============================================================
+#include "AlarmEngine.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Same clock and resolution as DmmSample::monoUs
+static int64_t NowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+AlarmEngine::AlarmEngine() {}
+
+const char* AlarmEngine::RuleName(int rule) const
+{
+    return rule >= 0 && rule < m_count ? m_rules[static_cast<size_t>(rule)].name : "";
+}
+
+// ----------------------------------------------------------------
+// Compiling
+// ----------------------------------------------------------------
+bool AlarmEngine::AddRule(const std::string& spec)
+{
+    if (m_count >= kMaxRules)
+    {
+        m_lastError = "too many alarm rules (at most " + std::to_string(kMaxRules) + ")";
+        return false;
+    }
+    Rule r;
+    if (!Compile(spec, r, m_lastError))
+        return false;
+    m_rules[static_cast<size_t>(m_count++)] = r;
+    return true;
+}
+
+void AlarmEngine::ClearRules()
+{
+    m_count = 0;
+}
+
+void AlarmEngine::Reset()
+{
+    for (int i = 0; i < m_count; ++i)
+    {
+        Rule& r    = m_rules[static_cast<size_t>(i)];
+        r.active   = false;
+        r.sinceUs  = -1;
+        r.havePrev = false;
+    }
+}
+
+// "4.5V", "4.5 V", "50mV", "0.5V/s": a number and a unit, in one token
+// or two.  The value is returned in base units.  A bare number takes
+// 'bareUnit' if one is given (the unit written after the high limit of
+// "outside 1 2V"); otherwise a missing or unknown unit is an error.
+static bool ParseQuantity(const std::vector<std::string>& tok, size_t& i, bool perSecond,
+                          double& value, DmmUnit& unitOut, std::string& error,
+                          DmmUnit bareUnit = DmmUnit::None)
+{
+    if (i >= tok.size()) { error = "value missing"; return false; }
+    const char* p   = tok[i].c_str();
+    char*       end = nullptr;
+    value = strtod(p, &end);
+    if (end == p) { error = "not a number: " + tok[i]; return false; }
+    std::string unit = end;
+    ++i;
+
+    DmmUnit u = bareUnit;
+    if (unit.empty() && u == DmmUnit::None && i < tok.size())
+        unit = tok[i++];
+    if (!unit.empty())
+    {
+        if (perSecond)
+        {
+            if (unit.size() < 2 || unit.compare(unit.size() - 2, 2, "/s") != 0)
+            {
+                error = "slope needs a unit per second, e.g. 0.5V/s";
+                return false;
+            }
+            unit.resize(unit.size() - 2);
+        }
+        u = DmmUnitFromText(unit);
+        if (u == DmmUnit::None) { error = "unknown unit: " + unit; return false; }
+    }
+    if (u == DmmUnit::None) { error = "unit missing after " + tok[i - 1]; return false; }
+
+    value  *= DmmUnitScale(u);
+    unitOut = u;
+    return true;
+}
+
+// "2s", "500 ms", "1min"
+static bool ParseDuration(const std::vector<std::string>& tok, size_t& i,
+                          int64_t& us, std::string& error)
+{
+    if (i >= tok.size()) { error = "time missing after 'for'"; return false; }
+    const char* p   = tok[i].c_str();
+    char*       end = nullptr;
+    double      v   = strtod(p, &end);
+    if (end == p || v < 0) { error = "not a time: " + tok[i]; return false; }
+    std::string unit = end;
+    ++i;
+    if (unit.empty() && i < tok.size()) unit = tok[i++];
+
+    double scale;
+    if      (unit == "ms")                  scale = 1e3;
+    else if (unit == "s")                   scale = 1e6;
+    else if (unit == "min")                 scale = 60e6;
+    else { error = "unknown time unit: " + unit; return false; }
+    us = static_cast<int64_t>(v * scale);
+    return true;
+}
+
+bool AlarmEngine::Compile(const std::string& spec, Rule& out, std::string& error)
+{
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos)
+    {
+        error = "expected \"<name>: <condition>\": " + spec;
+        return false;
+    }
+
+    // Name, trimmed and truncated to the fixed field
+    size_t b = spec.find_first_not_of(" \t");
+    size_t e = spec.find_last_not_of(" \t", colon == 0 ? 0 : colon - 1);
+    std::string name = (b < colon && e != std::string::npos) ? spec.substr(b, e - b + 1) : "";
+    if (name.empty()) { error = "rule has no name: " + spec; return false; }
+    strncpy(out.name, name.c_str(), sizeof(out.name) - 1);
+
+    std::vector<std::string> tok;
+    for (size_t i = colon + 1; i < spec.size(); )
+    {
+        i = spec.find_first_not_of(" \t", i);
+        if (i == std::string::npos) break;
+        size_t j = spec.find_first_of(" \t", i);
+        if (j == std::string::npos) j = spec.size();
+        tok.push_back(spec.substr(i, j - i));
+        i = j;
+    }
+    if (tok.empty()) { error = name + ": condition missing"; return false; }
+
+    size_t i = 1;
+    const std::string& what = tok[0];
+    bool ok = true;
+    DmmUnit unit = DmmUnit::None;
+    if (what == "above" || what == "below")
+    {
+        out.test = what == "above" ? Test::Above : Test::Below;
+        ok = ParseQuantity(tok, i, false, out.hi, unit, error);
+        out.lo = out.hi;
+    }
+    else if (what == "outside")
+    {
+        // "outside 1V 2V", or "outside 1 2V" with the unit written once
+        out.test = Test::Outside;
+        size_t  loTok  = i;
+        DmmUnit loUnit = DmmUnit::None;
+        bool    bare   = i < tok.size() && !tok[i].empty() &&
+                         tok[i].find_first_not_of("+-.0123456789eE") == std::string::npos;
+        if (bare)
+        {
+            ++i;
+            ok = ParseQuantity(tok, i, false, out.hi, unit, error);
+            size_t k = loTok;
+            ok = ok && ParseQuantity(tok, k, false, out.lo, loUnit, error, unit);
+        }
+        else
+        {
+            ok = ParseQuantity(tok, i, false, out.lo, loUnit, error) &&
+                 ParseQuantity(tok, i, false, out.hi, unit, error);
+        }
+        if (ok && DmmBaseUnit(loUnit) != DmmBaseUnit(unit))
+        {
+            error = name + ": both limits must be the same quantity";
+            return false;
+        }
+        if (ok && out.lo > out.hi)
+            std::swap(out.lo, out.hi);
+    }
+    else if (what == "slope")
+    {
+        out.test = Test::Slope;
+        ok = ParseQuantity(tok, i, true, out.hi, unit, error);
+        out.hi = std::fabs(out.hi);
+    }
+    else if (what == "ol" || what == "OL" || what == "short" || what == "SHORT" ||
+             what == "open" || what == "OPEN")
+    {
+        out.test = Test::Kind;
+        out.kind = (what == "ol" || what == "OL") ? DmmValueKind::Overload
+                 : (what == "short" || what == "SHORT") ? DmmValueKind::Short
+                 : DmmValueKind::Open;
+    }
+    else
+    {
+        error = name + ": unknown condition '" + what + "'";
+        return false;
+    }
+    if (!ok) { error = name + ": " + error; return false; }
+    out.base = out.test == Test::Kind ? DmmUnit::None : DmmBaseUnit(unit);
+
+    // Modifiers
+    while (i < tok.size())
+    {
+        const std::string& m = tok[i++];
+        if (m == "for")
+        {
+            if (!ParseDuration(tok, i, out.holdUs, error)) { error = name + ": " + error; return false; }
+        }
+        else if (m == "hyst" && out.test != Test::Kind)
+        {
+            DmmUnit hu = DmmUnit::None;
+            if (!ParseQuantity(tok, i, out.test == Test::Slope, out.hyst, hu, error))
+            {
+                error = name + ": " + error;
+                return false;
+            }
+            if (DmmBaseUnit(hu) != out.base)
+            {
+                error = name + ": hysteresis must be the same quantity as the limit";
+                return false;
+            }
+            out.hyst = std::fabs(out.hyst);
+        }
+        else
+        {
+            error = name + ": unexpected '" + m + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------
+// Evaluation (reader thread; no allocation)
+// ----------------------------------------------------------------
+void AlarmEngine::Evaluate(const DmmSample& s)
+{
+    const DmmUnit base = DmmBaseUnit(s.unit);
+    const double  x    = s.scaled;
+    const bool    num  = s.kind == DmmValueKind::Numeric && !std::isnan(x);
+
+    for (int idx = 0; idx < m_count; ++idx)
+    {
+        Rule& r = m_rules[static_cast<size_t>(idx)];
+        bool cond  = false;         // alarm condition holds
+        bool clear = true;          // far enough back to clear an active alarm
+
+        if (r.test == Test::Kind)
+        {
+            cond  = s.kind == r.kind;
+            clear = !cond;
+        }
+        else if (!num)
+        {
+            // OL and the like say nothing about a limit; keep the state.
+            r.havePrev = false;
+            continue;
+        }
+        else if (base != r.base)
+        {
+            // Another quantity: the rule no longer applies.
+            r.havePrev = false;
+        }
+        else switch (r.test)
+        {
+            case Test::Above:
+                cond  = x > r.hi;
+                clear = x <= r.hi - r.hyst;
+                break;
+            case Test::Below:
+                cond  = x < r.lo;
+                clear = x >= r.lo + r.hyst;
+                break;
+            case Test::Outside:
+                cond  = x < r.lo || x > r.hi;
+                clear = x >= r.lo + r.hyst && x <= r.hi - r.hyst;
+                break;
+            case Test::Slope:
+            {
+                bool   have = r.havePrev && s.monoUs > r.prevUs;
+                double rate = have ? std::fabs(x - r.prevValue) * 1e6 /
+                                     static_cast<double>(s.monoUs - r.prevUs)
+                                   : 0.0;
+                r.havePrev  = true;
+                r.prevValue = x;
+                r.prevUs    = s.monoUs;
+                if (!have) continue;
+                cond  = rate > r.hi;
+                clear = rate <= r.hi - r.hyst;
+                break;
+            }
+            case Test::Kind:
+                break;
+        }
+
+        if (!r.active)
+        {
+            if (!cond) { r.sinceUs = -1; continue; }
+            if (r.sinceUs < 0) r.sinceUs = s.monoUs;
+            if (s.monoUs - r.sinceUs >= r.holdUs)
+            {
+                r.active = true;
+                Fire(idx, true, s);
+            }
+        }
+        else if (clear)
+        {
+            r.active  = false;
+            r.sinceUs = -1;
+            Fire(idx, false, s);
+        }
+    }
+}
+
+void AlarmEngine::Fire(int index, bool raised, const DmmSample& s)
+{
+    AlarmEvent ev;
+    ev.rule      = index;
+    ev.raised    = raised;
+    ev.kind      = s.kind;
+    ev.unit      = s.unit;
+    ev.value     = s.kind == DmmValueKind::Numeric ? s.scaled : std::nan("");
+    ev.wallUs    = s.wallUs;
+    ev.monoUs    = s.monoUs;
+    ev.latencyUs = NowUs() - s.rxUs;
+
+    // Single writer: plain load / store is enough for the counters.
+    m_lastLatencyUs.store(ev.latencyUs, std::memory_order_relaxed);
+    if (ev.latencyUs > m_worstLatencyUs.load(std::memory_order_relaxed))
+        m_worstLatencyUs.store(ev.latencyUs, std::memory_order_relaxed);
+    m_fired.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_handler)
+        m_handler(ev);
+    m_events.TryPush(ev);
+}
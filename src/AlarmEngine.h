@@ -0,0 +1,131 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — AlarmEngine.h
+//  Threshold / alarm rules evaluated on the reader thread.
+//
+//  Rules are compiled once from text (the [Alarms] section of
+//  the INI file) into a fixed table, and Evaluate() runs every
+//  rule against each reading straight after the stream parser
+//  has produced it — before the log, the history, the stats and
+//  the hop to the GUI.  Evaluation allocates nothing: rule
+//  state lives in the table and transitions go into a lock-free
+//  queue (and to an optional handler on the same thread).
+//
+//  Rule syntax, one per key:
+//
+//    <name>: <condition> [for <time>] [hyst <value>]
+//
+//    above <value><unit>           reading > value
+//    below <value><unit>           reading < value
+//    outside <lo> <hi><unit>       reading outside [lo, hi]
+//    slope <value><unit>/s         |change per second| > value
+//    ol | short | open             special value on the display
+//
+//  e.g. "Overvolt: above 4.5V for 2s hyst 50mV".  Units are
+//  the meter's tokens (V, mV, KOH ...) or their display text; a
+//  rule only looks at readings of that quantity, in any range.
+//  'for' delays raising until the condition has held that long
+//  (ms, s or min); 'hyst' is how far the reading must come back
+//  inside before the alarm clears.
+//
+//  Trigger latency — from the reading's CR (DmmSample::rxUs)
+//  to the moment its transition is decided — is measured for
+//  every event.
+// ============================================================
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "DmmParser.h"
+#include "SpscQueue.h"
+
+struct AlarmEvent
+{
+    int          rule      = -1;         // index into the rule table
+    bool         raised    = false;      // false: cleared
+    DmmValueKind kind      = DmmValueKind::Numeric;
+    DmmUnit      unit      = DmmUnit::None;
+    double       value     = 0.0;        // reading in base units (NaN if not numeric)
+    int64_t      wallUs    = 0;          // of the reading
+    int64_t      monoUs    = 0;
+    int64_t      latencyUs = 0;          // CR seen → transition decided
+};
+
+class AlarmEngine
+{
+public:
+    static const int kMaxRules = 32;
+    using EventQueue = SpscQueue<AlarmEvent, 256>;
+    using Handler    = std::function<void(const AlarmEvent& ev)>;
+
+    AlarmEngine();
+
+    AlarmEngine(const AlarmEngine&) = delete;
+    AlarmEngine& operator=(const AlarmEngine&) = delete;
+
+    // Rule table.  Only change it while no thread is evaluating.
+    // AddRule() returns false with LastError() set if 'spec' does not
+    // compile or the table is full.
+    bool AddRule(const std::string& spec);
+    void ClearRules();
+    int  RuleCount() const { return m_count; }
+    const char* RuleName(int rule) const;
+    std::string LastError() const { return m_lastError; }
+
+    // Called on the evaluating thread for every transition, before the
+    // event is queued.  Set it before evaluation starts; must not block.
+    void SetHandler(Handler fn) { m_handler = std::move(fn); }
+
+    // Reader thread: run every rule against one reading.
+    void Evaluate(const DmmSample& s);
+
+    // Forget all rule state (active alarms, pending timers).  From the
+    // evaluating thread, or while no thread is evaluating.
+    void Reset();
+
+    // Consumer side of the transition queue (one thread).
+    bool PopEvent(AlarmEvent& out) { return m_events.TryPop(out); }
+
+    // Latency of the last event and the worst so far, in microseconds,
+    // and the number of transitions (any thread).
+    int64_t  LastLatencyUs()  const { return m_lastLatencyUs.load(std::memory_order_relaxed); }
+    int64_t  WorstLatencyUs() const { return m_worstLatencyUs.load(std::memory_order_relaxed); }
+    uint64_t Events()         const { return m_fired.load(std::memory_order_relaxed); }
+    uint64_t DroppedEvents()  const { return m_events.Dropped(); }
+
+private:
+    enum class Test : uint8_t { Above, Below, Outside, Slope, Kind };
+
+    struct Rule
+    {
+        char         name[32]  = {};
+        Test         test      = Test::Above;
+        DmmUnit      base      = DmmUnit::None;     // None: any quantity (Kind rules)
+        DmmValueKind kind      = DmmValueKind::Overload;
+        double       lo        = 0.0;               // base units (per second for Slope)
+        double       hi        = 0.0;
+        double       hyst      = 0.0;
+        int64_t      holdUs    = 0;
+
+        // State
+        bool         active    = false;
+        int64_t      sinceUs   = -1;                // condition true since; -1 = not
+        bool         havePrev  = false;             // Slope: previous reading
+        double       prevValue = 0.0;
+        int64_t      prevUs    = 0;
+    };
+
+    static bool Compile(const std::string& spec, Rule& out, std::string& error);
+    void Fire(int index, bool raised, const DmmSample& s);
+
+    std::array<Rule, kMaxRules> m_rules;
+    int                   m_count = 0;
+    std::string           m_lastError;
+    Handler               m_handler;
+    EventQueue            m_events;
+
+    std::atomic<int64_t>  m_lastLatencyUs{0};
+    std::atomic<int64_t>  m_worstLatencyUs{0};
+    std::atomic<uint64_t> m_fired{0};
+};
@@ -0,0 +1,329 @@
+// ============================================================
+//  Protek506Logger — AsyncLogWriter.cpp
+// ============================================================
+#include "AsyncLogWriter.h"
+#include <chrono>
+#include "BinLogger.h"
+#include "CsvLogger.h"
+
+// Samples moved per pass of the writer loop, and how often it wakes
+// with nothing to do so time-based flushes still happen.
+static const size_t BATCH_MAX = 256;
+static const int    IDLE_TICK_MS = 100;
+
+// Rows awaiting a flush whose CR times are kept for the LogFlush stage;
+// beyond this (a policy that hardly ever flushes) rows go untimed.
+static const size_t FLUSH_TIMED_MAX = 65536;
+
+AsyncLogWriter::AsyncLogWriter()
+    : m_open(false), m_rows(0), m_bytes(0), m_flushes(0), m_worstFlushUs(0),
+      m_dropped(0), m_spilled(0), m_highWater(0)
+{
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    Close();
+}
+
+std::string AsyncLogWriter::LastError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+// ----------------------------------------------------------------
+// Open / Close (any thread)
+// ----------------------------------------------------------------
+bool AsyncLogWriter::Open(const std::string& filePath,
+                          const LogFlushPolicy& flush,
+                          LogOverflow overflow,
+                          size_t capacity)
+{
+    Close();
+
+    const std::string ext = ".p506";
+    bool binary = filePath.size() > ext.size() &&
+                  filePath.compare(filePath.size() - ext.size(), ext.size(), ext) == 0;
+    if (binary)
+        m_logger.reset(new BinLogger);
+    else
+    {
+        CsvLogger* csv = new CsvLogger;
+        csv->SetTimeFormat(m_timeFormat);
+        m_logger.reset(csv);
+    }
+
+    m_logger->SetFlushPolicy(flush);
+    if (!m_logger->Open(filePath))
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = m_logger->LastError();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ring.assign(capacity > 0 ? capacity : 1, DmmSample());
+        m_head     = 0;
+        m_count    = 0;
+        m_overflow = overflow;
+        m_stop     = false;
+        m_failed   = false;
+        m_lastError.clear();
+    }
+    m_rows = 0;
+    m_bytes = m_logger->BytesWritten();
+    m_flushes = 0;
+    m_worstFlushUs = 0;
+    m_dropped = 0;
+    m_spilled = 0;
+    m_highWater = 0;
+    m_unflushedUs.clear();
+    m_seenFlushes = 0;
+
+    m_open   = true;
+    m_thread = std::thread(&AsyncLogWriter::Run, this);
+    return true;
+}
+
+void AsyncLogWriter::Close()
+{
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+    m_thread.join();
+    m_open = false;
+}
+
+// ----------------------------------------------------------------
+// Producer
+// ----------------------------------------------------------------
+bool AsyncLogWriter::Push(const DmmSample& s)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_open.load() || m_stop || m_failed) return false;
+
+    // Once samples are spilling, later ones follow them into the file
+    // until it has drained; otherwise they would be written out of order.
+    if (m_spillCount > 0)
+    {
+        bool ok = SpillLocked(s);
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return ok;
+    }
+
+    const size_t cap = m_ring.size();
+    if (m_count == cap)
+    {
+        switch (m_overflow)
+        {
+            case LogOverflow::Block:
+                m_notFull.wait(lock, [this, cap] {
+                    return m_count < cap || m_stop || m_failed;
+                });
+                if (m_stop || m_failed) return false;
+                break;
+
+            case LogOverflow::DropOldest:
+                m_head = (m_head + 1) % cap;
+                --m_count;
+                ++m_dropped;
+                break;
+
+            case LogOverflow::Spill:
+            {
+                bool ok = SpillLocked(s);
+                lock.unlock();
+                m_notEmpty.notify_one();
+                return ok;
+            }
+        }
+    }
+
+    m_ring[(m_head + m_count) % cap] = s;
+    bool wake = (++m_count == 1);
+    if (m_count > m_highWater.load(std::memory_order_relaxed))
+        m_highWater.store(m_count, std::memory_order_relaxed);
+    lock.unlock();
+
+    if (wake)
+        m_notEmpty.notify_one();
+    return true;
+}
+
+// ----------------------------------------------------------------
+// Spill file.  Samples are trivially copyable, so they are stored
+// as-is: appended at the end, read back from m_spillRead.
+// ----------------------------------------------------------------
+bool AsyncLogWriter::SpillLocked(const DmmSample& s)
+{
+    if (!m_spill)
+    {
+        m_spill     = tmpfile();
+        m_spillRead = 0;
+        if (!m_spill)
+        {
+            ++m_dropped;            // nowhere to put it
+            return false;
+        }
+    }
+    if (fseek(m_spill, 0, SEEK_END) != 0 ||
+        fwrite(&s, sizeof(s), 1, m_spill) != 1)
+    {
+        ++m_dropped;
+        return false;
+    }
+    ++m_spillCount;
+    ++m_spilled;
+    return true;
+}
+
+size_t AsyncLogWriter::UnspillLocked(std::vector<DmmSample>& out, size_t max)
+{
+    size_t want = m_spillCount < max ? m_spillCount : max;
+    size_t base = out.size();
+    out.resize(base + want);
+
+    size_t got = 0;
+    if (fseek(m_spill, m_spillRead, SEEK_SET) == 0)
+        got = fread(out.data() + base, sizeof(DmmSample), want, m_spill);
+    out.resize(base + got);
+
+    m_spillRead  += static_cast<long>(got * sizeof(DmmSample));
+    m_spillCount -= got;
+    if (got < want)
+    {
+        // Unreadable spill file: count what is left as lost
+        m_dropped    += m_spillCount;
+        m_spillCount  = 0;
+    }
+    if (m_spillCount == 0)
+    {
+        fclose(m_spill);            // tmpfile() removes itself
+        m_spill     = nullptr;
+        m_spillRead = 0;
+    }
+    return got;
+}
+
+// ----------------------------------------------------------------
+// Writer thread
+// ----------------------------------------------------------------
+void AsyncLogWriter::Run()
+{
+    std::vector<DmmSample> batch;
+    batch.reserve(BATCH_MAX);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_notEmpty.wait_for(lock, std::chrono::milliseconds(IDLE_TICK_MS), [this] {
+            return m_stop || m_count > 0 || m_spillCount > 0;
+        });
+
+        // The ring always holds the oldest samples; the spill file only
+        // starts once the ring is full, so it is read after the ring.
+        batch.clear();
+        const size_t cap = m_ring.size();
+        while (m_count > 0 && batch.size() < BATCH_MAX)
+        {
+            batch.push_back(m_ring[m_head]);
+            m_head = (m_head + 1) % cap;
+            --m_count;
+        }
+        if (batch.empty() && m_spillCount > 0)
+            UnspillLocked(batch, BATCH_MAX);
+
+        const bool failed = m_failed;
+        const bool done   = m_stop && m_count == 0 && m_spillCount == 0;
+        lock.unlock();
+
+        if (!batch.empty())
+            m_notFull.notify_all();
+        if (!failed)
+            WriteBatch(batch);
+
+        lock.lock();
+        if (done || (m_stop && m_failed))
+            break;
+    }
+    lock.unlock();
+
+    bool wasOk = m_logger->WriteOk();
+    m_logger->Close();               // final flush (and sync, if configured)
+    if (m_latency && wasOk && m_logger->WriteOk())
+        NoteFlushes();
+    m_flushes      = m_logger->FlushCount();
+    m_worstFlushUs = m_logger->WorstFlushUs();
+    if (wasOk && !m_logger->WriteOk())
+        Fail(m_logger->LastError());
+}
+
+void AsyncLogWriter::WriteBatch(const std::vector<DmmSample>& batch)
+{
+    for (const DmmSample& s : batch)
+    {
+        m_logger->Write(s);
+        if (!m_logger->WriteOk()) break;
+        if (m_latency)
+        {
+            m_latency->Record(LatencyStage::LogWrite, s.rxUs, LatencyStats::NowUs());
+            if (m_unflushedUs.size() < FLUSH_TIMED_MAX)
+                m_unflushedUs.push_back(s.rxUs);
+            NoteFlushes();          // a row-count policy flushes inside Write()
+        }
+    }
+    if (m_logger->WriteOk())
+        m_logger->Tick();
+    if (m_latency)
+        NoteFlushes();
+
+    m_rows         = m_logger->RowCount();
+    m_bytes        = m_logger->BytesWritten();
+    m_flushes      = m_logger->FlushCount();
+    m_worstFlushUs = m_logger->WorstFlushUs();
+
+    if (!m_logger->WriteOk())
+        Fail(m_logger->LastError());
+}
+
+// Writer thread: if the backend has flushed since the last call, every
+// row written before that is now in the file.
+void AsyncLogWriter::NoteFlushes()
+{
+    uint64_t flushes = m_logger->FlushCount();
+    if (flushes == m_seenFlushes) return;
+    m_seenFlushes = flushes;
+
+    int64_t now = LatencyStats::NowUs();
+    for (int64_t us : m_unflushedUs)
+        m_latency->Record(LatencyStage::LogFlush, us, now);
+    m_unflushedUs.clear();
+}
+
+void AsyncLogWriter::Fail(const std::string& msg)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failed    = true;
+        m_lastError = msg;
+        m_dropped  += m_count + m_spillCount;
+        m_count     = 0;
+        m_spillCount = 0;
+        if (m_spill)
+        {
+            fclose(m_spill);
+            m_spill = nullptr;
+        }
+    }
+    m_open = false;
+    m_notFull.notify_all();
+    if (m_onError)
+        m_onError(msg);
+}
@@ -0,0 +1,127 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — AsyncLogWriter.h
+//  Session logging on a dedicated writer thread.
+//
+//  The acquisition side calls Push() with each sample; a bounded
+//  queue hands them to a writer thread that owns the log backend
+//  (CsvLogger, or BinLogger for a *.p506 file name),
+//  so a slow disk or network share stalls this thread instead of
+//  the GUI.  When the queue is full the chosen policy applies:
+//
+//    Block      the producer waits for space (nothing is lost,
+//               but acquisition stalls with the disk);
+//    DropOldest the oldest queued sample is discarded (counted);
+//    Spill      samples go to an anonymous temporary file and are
+//               written, in order, once the queue has drained.
+//
+//  Open/Close and the counters may be used from any thread;
+//  Push() from one producer at a time.  Write errors stop the
+//  writer and are reported once through the error callback,
+//  called on the writer thread.  The class is wx-free.
+// ============================================================
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SampleLog.h"
+#include "LatencyStats.h"
+#include "TimestampFormatter.h"
+
+enum class LogOverflow : uint8_t { Block, DropOldest, Spill };
+
+class AsyncLogWriter
+{
+public:
+    using ErrorHandler = std::function<void(const std::string& msg)>;
+
+    AsyncLogWriter();
+    ~AsyncLogWriter();
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+    // Set before Open(); not synchronised.
+    void SetErrorHandler(ErrorHandler fn) { m_onError = std::move(fn); }
+
+    // Time the LogWrite and LogFlush stages into 'stats' (may be null;
+    // must outlive the writer).  Set before Open().
+    void SetLatencyStats(LatencyStats* stats) { m_latency = stats; }
+
+    // Resolution of the CSV time column (the binary log ignores it).
+    // Set before Open().
+    void SetTimeFormat(LogTimeFormat format) { m_timeFormat = format; }
+
+    // Open the log file (in the caller's thread, so errors are immediate;
+    // see LastError()) and start the writer thread.  The backend is
+    // chosen from the extension: ".p506" is binary, anything else CSV.
+    bool Open(const std::string& filePath,
+              const LogFlushPolicy& flush,
+              LogOverflow overflow = LogOverflow::Block,
+              size_t capacity = 4096);
+
+    // Write out everything queued or spilled, then close the file.
+    void Close();
+    bool IsOpen() const { return m_open.load(); }
+
+    // Queue one sample.  Returns false if it was not accepted (writer
+    // closed or failed); a DropOldest overflow still returns true.
+    bool Push(const DmmSample& s);
+
+    std::string LastError() const;
+
+    // Counters (any thread; updated after each written batch)
+    long     RowCount()     const { return m_rows.load(); }
+    uint64_t BytesWritten() const { return m_bytes.load(); }
+    uint64_t FlushCount()   const { return m_flushes.load(); }
+    int64_t  WorstFlushUs() const { return m_worstFlushUs.load(); }
+    uint64_t Dropped()      const { return m_dropped.load(); }
+    uint64_t Spilled()      const { return m_spilled.load(); }
+    size_t   HighWater()    const { return m_highWater.load(); }
+
+private:
+    void Run();
+    void WriteBatch(const std::vector<DmmSample>& batch);
+    bool SpillLocked(const DmmSample& s);
+    size_t UnspillLocked(std::vector<DmmSample>& out, size_t max);
+    void NoteFlushes();
+    void Fail(const std::string& msg);
+
+    std::unique_ptr<SampleLog> m_logger;   // writer thread only once open
+    std::thread             m_thread;
+    ErrorHandler            m_onError;
+    LatencyStats*           m_latency = nullptr;
+    LogTimeFormat           m_timeFormat = LogTimeFormat::Tenths;
+    std::vector<int64_t>    m_unflushedUs;      // writer thread: CR times of rows not yet flushed
+    uint64_t                m_seenFlushes = 0;
+
+    mutable std::mutex      m_mutex;       // guards everything below up to the counters
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::vector<DmmSample>  m_ring;
+    size_t                  m_head     = 0;
+    size_t                  m_count    = 0;
+    LogOverflow             m_overflow = LogOverflow::Block;
+    bool                    m_stop     = false;
+    bool                    m_failed   = false;
+    std::string             m_lastError;
+
+    FILE*                   m_spill       = nullptr;   // tmpfile(), Spill policy only
+    long                    m_spillRead   = 0;         // byte offset of the next unread sample
+    size_t                  m_spillCount  = 0;         // samples in the file not yet written
+
+    std::atomic<bool>       m_open;
+    std::atomic<long>       m_rows;
+    std::atomic<uint64_t>   m_bytes;
+    std::atomic<uint64_t>   m_flushes;
+    std::atomic<int64_t>    m_worstFlushUs;
+    std::atomic<uint64_t>   m_dropped;
+    std::atomic<uint64_t>   m_spilled;
+    std::atomic<size_t>     m_highWater;
+};
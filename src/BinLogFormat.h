@@ -0,0 +1,198 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — BinLogFormat.h
+//  On-disk layout of the binary session log (*.p506).
+//
+//  Little-endian, in the host's native layout (x86 / ARM, i.e.
+//  every platform the logger is built for):
+//
+//    [header] [record x N] [footer] [record x N] [footer] ...
+//
+//  A header starts each logging session (a file that is opened
+//  again gets another header appended).  It anchors the records'
+//  monotonic timestamps to wall-clock time.  After every
+//  chunkRecords records, and at the end of a session, a footer
+//  summarises the chunk before it: record count and length, time
+//  span, value range and a checksum, so a reader can validate or
+//  skip whole chunks without decoding them.
+//
+//  Headers and footers are 64-byte slots.  A record is a fixed
+//  24-byte head holding the parser's output - monoUs, the value
+//  as a double, mode / unit / kind and the value and unit spans
+//  - followed by the raw line, 24 + rawLen bytes (34 for
+//  "DC 3.999 V").  Reading a record is a copy: values, times
+//  and footers are checked without parsing any text, and the
+//  raw line is there for the CSV's raw column.  Versions 1 and 2
+//  (fixed 64-byte records; monoUs and the raw line only, parsed
+//  again on reading) are not read.
+//
+//  Headers and footers identify themselves: they begin with an
+//  8-byte magic that, read as a record's monoUs, would be more
+//  than 2000 years of uptime.  A file cut short by a crash ends
+//  in records without a footer; they are still readable.
+// ============================================================
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "DmmParser.h"
+
+namespace binlog
+{
+
+static constexpr size_t   kSlotSize     = 64;     // header or footer
+static constexpr uint16_t kVersion      = 3;
+static constexpr uint32_t kChunkRecords = 1024;
+
+static constexpr char kHeaderMagic[8] = { 'P', '5', '0', '6', 'L', 'O', 'G', '\x01' };
+static constexpr char kFooterMagic[8] = { 'P', '5', '0', '6', 'C', 'H', 'K', '\x01' };
+
+struct Header
+{
+    char     magic[8];          // kHeaderMagic
+    uint16_t version;           // kVersion
+    uint16_t slotSize;          // kSlotSize
+    uint32_t chunkRecords;      // records between footers
+    int64_t  wallAnchorUs;      // system_clock at session start, µs since epoch
+    int64_t  monoAnchorUs;      // steady_clock at the same instant, µs
+    char     reserved[32];
+};
+
+// A record's head, followed by rawLen bytes of the line as received,
+// without its CR.  Records are unaligned; copy the head out.
+struct RecordHead
+{
+    int64_t  monoUs;            // DmmSample::monoUs
+    double   value;             // DmmSample::value; NaN if not numeric
+    uint8_t  mode;              // DmmMode
+    uint8_t  unit;              // DmmUnit
+    uint8_t  kind;              // DmmValueKind
+    uint8_t  rawLen;            // 1 .. DmmSample::kRawMax
+    uint8_t  valueOff;          // value and unit tokens within the raw line
+    uint8_t  valueLen;
+    uint8_t  unitOff;
+    uint8_t  unitLen;
+};
+
+static constexpr size_t kRecordHead = sizeof(RecordHead);
+static constexpr size_t kRecordMax  = kRecordHead + DmmSample::kRawMax;
+
+struct Footer
+{
+    char     magic[8];          // kFooterMagic
+    uint32_t count;             // records in this chunk
+    uint32_t checksum;          // Checksum() over those records
+    int64_t  firstMonoUs;
+    int64_t  lastMonoUs;
+    double   minValue;          // over numeric records; NaN if none
+    double   maxValue;
+    uint32_t bytes;             // the records' total length
+    char     reserved[12];
+};
+
+static_assert(sizeof(Header) == kSlotSize, "binlog header must fill one slot");
+static_assert(sizeof(Footer) == kSlotSize, "binlog footer must fill one slot");
+static_assert(sizeof(RecordHead) == 24, "binlog record head must stay 24 bytes");
+
+inline bool IsHeader(const void* slot) { return memcmp(slot, kHeaderMagic, 8) == 0; }
+inline bool IsFooter(const void* slot) { return memcmp(slot, kFooterMagic, 8) == 0; }
+
+// A multiply-xor hash taken 8 bytes at a time (the last word zero-
+// padded), continued across calls by passing the previous result.
+// Byte-wise FNV-1a held the reader to ~600 MB/s; this runs at memory
+// speed.  It catches damage, not tampering.
+inline uint32_t Checksum(const void* data, size_t len, uint32_t h = 2166136261u)
+{
+    if (len == 0) return h;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t x = h ^ (static_cast<uint64_t>(len) << 32);
+    for (; len >= 8; p += 8, len -= 8)
+    {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        x = (x ^ w) * 0x9e3779b97f4a7c15ull;
+        x ^= x >> 32;
+    }
+    if (len > 0)
+    {
+        uint64_t w = 0;
+        for (size_t i = 0; i < len; ++i)
+            w |= static_cast<uint64_t>(p[i]) << (8 * i);
+        x = (x ^ w) * 0x9e3779b97f4a7c15ull;
+        x ^= x >> 32;
+    }
+    return static_cast<uint32_t>(x);
+}
+
+// Encode s into out (kRecordMax bytes); returns the record's length.
+inline size_t ToRecord(const DmmSample& s, uint8_t* out)
+{
+    RecordHead h;
+    h.monoUs   = s.monoUs;
+    h.value    = s.value;
+    h.mode     = static_cast<uint8_t>(s.mode);
+    h.unit     = static_cast<uint8_t>(s.unit);
+    h.kind     = static_cast<uint8_t>(s.kind);
+    h.rawLen   = s.rawLen;
+    h.valueOff = s.valueOff;
+    h.valueLen = s.valueLen;
+    h.unitOff  = s.unitOff;
+    h.unitLen  = s.unitLen;
+    memcpy(out, &h, sizeof(h));
+    memcpy(out + kRecordHead, s.raw, s.rawLen);
+    return kRecordHead + s.rawLen;
+}
+
+// The rawLen byte of the record at rec (kRecordHead bytes available).
+inline uint8_t RawLength(const uint8_t* rec)
+{
+    return rec[offsetof(RecordHead, rawLen)];
+}
+
+// Length of the record at rec, or 0 if fewer than 'avail' bytes hold
+// it or its head is impossible (a length, enum or span out of range).
+inline size_t RecordLength(const uint8_t* rec, size_t avail)
+{
+    if (avail < kRecordHead) return 0;
+    RecordHead h;
+    memcpy(&h, rec, sizeof(h));
+    size_t len = kRecordHead + h.rawLen;
+    if (h.rawLen == 0 || len > kRecordMax || len > avail) return 0;
+    if (h.mode > static_cast<uint8_t>(DmmMode::TEMP) ||
+        h.unit > static_cast<uint8_t>(DmmUnit::DegF) ||
+        h.kind > static_cast<uint8_t>(DmmValueKind::Undefined) ||
+        h.valueOff + h.valueLen > h.rawLen || h.unitOff + h.unitLen > h.rawLen)
+        return 0;
+    return len;
+}
+
+// Decode a record that RecordLength() accepted, dating it from its
+// session header.  When 'avail' allows, the raw line is copied as a
+// whole kRawMax block: a fixed-size copy is several times faster than
+// one of rawLen bytes, whose length changes from record to record.
+// The bytes past rawLen are then whatever followed the record.
+inline void FromRecord(const uint8_t* rec, size_t avail, const Header& hdr, DmmSample& s)
+{
+    RecordHead h;
+    memcpy(&h, rec, sizeof(h));
+    s.monoUs    = h.monoUs;
+    s.wallUs    = hdr.wallAnchorUs + (h.monoUs - hdr.monoAnchorUs);
+    s.triggerUs = 0;
+    s.rxUs      = 0;
+    s.queuedUs  = 0;
+    s.value     = h.value;
+    s.mode      = static_cast<DmmMode>(h.mode);
+    s.unit      = static_cast<DmmUnit>(h.unit);
+    s.kind      = static_cast<DmmValueKind>(h.kind);
+    s.scaled    = h.value * DmmUnitScale(s.unit);
+    s.rawLen    = h.rawLen;
+    s.valueOff  = h.valueOff;
+    s.valueLen  = h.valueLen;
+    s.unitOff   = h.unitOff;
+    s.unitLen   = h.unitLen;
+    if (avail >= kRecordMax)
+        memcpy(s.raw, rec + kRecordHead, DmmSample::kRawMax);
+    else
+        memcpy(s.raw, rec + kRecordHead, h.rawLen);
+}
+
+} // namespace binlog
@@ -0,0 +1,220 @@
+// ============================================================
+//  Protek506Logger — BinLogReader.cpp
+// ============================================================
+#include "BinLogReader.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+using namespace binlog;
+
+BinLogReader::BinLogReader() { memset(&m_header, 0, sizeof(m_header)); }
+BinLogReader::~BinLogReader() { Close(); }
+
+#ifdef _WIN32
+// ========================= WINDOWS ==============================
+
+bool BinLogReader::Open(const std::string& filePath)
+{
+    Close();
+    HANDLE f = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE)
+    {
+        m_lastError = "Cannot open file: " + filePath;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size))
+    {
+        CloseHandle(f);
+        m_lastError = "Cannot size file: " + filePath;
+        return false;
+    }
+    m_file = f;
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) { Rewind(); return true; }    // nothing to map
+
+    HANDLE map = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = map ? MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        if (map) CloseHandle(map);
+        Close();
+        m_lastError = "Cannot map file: " + filePath;
+        return false;
+    }
+    m_mapping = map;
+    m_data    = static_cast<const uint8_t*>(view);
+    Rewind();
+    return true;
+}
+
+void BinLogReader::Close()
+{
+    if (m_data)    UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file)    CloseHandle(static_cast<HANDLE>(m_file));
+    m_data = nullptr; m_mapping = nullptr; m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+// ========================= POSIX ================================
+
+bool BinLogReader::Open(const std::string& filePath)
+{
+    Close();
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        m_lastError = "Cannot open file: " + filePath + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        m_lastError = std::string("Cannot size file: ") + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size > 0)
+    {
+        void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            m_lastError = std::string("Cannot map file: ") + strerror(errno);
+            ::close(fd);
+            m_size = 0;
+            return false;
+        }
+        // One front-to-back pass: let the kernel read ahead aggressively
+        madvise(p, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(p);
+    }
+    ::close(fd);                    // the mapping keeps the file
+    Rewind();
+    return true;
+}
+
+void BinLogReader::Close()
+{
+    if (m_data)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+// ================================================================
+// Scanning (all platforms)
+// ================================================================
+void BinLogReader::Rewind()
+{
+    m_pos        = 0;
+    m_haveHeader = false;
+    m_chunkCount = 0;
+    m_chunkSum   = Checksum(nullptr, 0);
+    m_sessions   = 0;
+    m_badChunks  = 0;
+    m_truncated  = false;
+    m_lastError.clear();
+}
+
+void BinLogReader::CheckFooter(const Footer& f)
+{
+    if (f.count != m_chunkCount || f.checksum != m_chunkSum)
+        ++m_badChunks;
+    m_chunkCount = 0;
+    m_chunkSum   = Checksum(nullptr, 0);
+}
+
+// Skip a damaged record and whatever follows it up to the next header
+// or footer, which is where the slot boundaries can be trusted again.
+void BinLogReader::Resync()
+{
+    ++m_badChunks;
+    m_chunkCount = 0;
+    m_chunkSum   = Checksum(nullptr, 0);
+    for (++m_pos; m_pos + kSlotSize <= m_size; ++m_pos)
+        if (IsHeader(m_data + m_pos) || IsFooter(m_data + m_pos))
+        {
+            // The footer of this chunk cannot match; don't count it again
+            if (IsFooter(m_data + m_pos))
+                m_pos += kSlotSize;
+            return;
+        }
+    m_pos = m_size;
+}
+
+bool BinLogReader::Next(DmmSample& out)
+{
+    while (m_pos < m_size)
+    {
+        const uint8_t* slot  = m_data + m_pos;
+        const size_t   avail = m_size - m_pos;
+
+        if (avail >= kSlotSize && IsHeader(slot))
+        {
+            Header h;
+            memcpy(&h, slot, sizeof(h));
+            if (h.version != kVersion)
+            {
+                m_lastError = "Unsupported binary log version " + std::to_string(h.version) +
+                              " (this build reads version " + std::to_string(kVersion) + ")";
+                m_pos = m_size;
+                return false;
+            }
+            m_pos       += kSlotSize;
+            m_header     = h;
+            m_haveHeader = true;
+            m_chunkCount = 0;       // a session ended without its last footer
+            m_chunkSum   = Checksum(nullptr, 0);
+            ++m_sessions;
+            continue;
+        }
+        if (avail >= kSlotSize && IsFooter(slot))
+        {
+            Footer f;
+            memcpy(&f, slot, sizeof(f));
+            m_pos += kSlotSize;
+            CheckFooter(f);
+            continue;
+        }
+
+        size_t len = RecordLength(slot, avail);
+        if (len == 0)
+        {
+            // Cut short by the end of the file (a crash mid-write) ...
+            if (avail < kRecordHead || IsHeader(slot) || IsFooter(slot) ||
+                (RawLength(slot) != 0 && RawLength(slot) <= DmmSample::kRawMax &&
+                 kRecordHead + RawLength(slot) > avail))
+            {
+                m_truncated = true;
+                m_pos = m_size;
+                return false;
+            }
+            // ... or damaged, with no length to step over it by
+            Resync();
+            continue;
+        }
+        m_pos += len;
+        ++m_chunkCount;
+        m_chunkSum = Checksum(slot, len, m_chunkSum);
+        if (!m_haveHeader)
+            continue;               // records before any header cannot be timed
+        FromRecord(slot, avail, m_header, out);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — BinLogReader.h
+//  Reads a binary session log (*.p506, see BinLogFormat.h)
+//  through a read-only memory map.
+//
+//  Records are copied straight out of the mapping, with no
+//  per-record I/O and no parsing.  Each
+//  chunk is checked against its footer (count and checksum) as
+//  it is read; a chunk that fails is still returned but counted
+//  in BadChunks().  A record with an impossible length cannot be
+//  stepped over: the reader skips to the next header or footer
+//  and counts the chunk as bad.  A header of another format
+//  version ends the file with LastError() set.
+// ============================================================
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "BinLogFormat.h"
+
+class BinLogReader
+{
+public:
+    BinLogReader();
+    ~BinLogReader();
+
+    BinLogReader(const BinLogReader&) = delete;
+    BinLogReader& operator=(const BinLogReader&) = delete;
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    // Next record in file order, with wallUs from its session header.
+    // Returns false at the end of the file, or at a header of another
+    // version (LastError() is then set).
+    bool Next(DmmSample& out);
+
+    // Go back to the first slot.
+    void Rewind();
+
+    uint64_t    Sessions()   const { return m_sessions; }
+    uint64_t    BadChunks()  const { return m_badChunks; }
+    bool        Truncated()  const { return m_truncated; }
+    std::string LastError()  const { return m_lastError; }
+
+private:
+    void CheckFooter(const binlog::Footer& f);
+    void Resync();
+
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void*          m_file    = nullptr;   // HANDLE
+    void*          m_mapping = nullptr;   // HANDLE
+#endif
+
+    size_t         m_pos = 0;             // byte offset of the next header, footer or record
+    binlog::Header m_header;              // current session
+    bool           m_haveHeader = false;
+    uint32_t       m_chunkCount = 0;      // records since the last footer
+    uint32_t       m_chunkSum   = 0;
+    uint64_t       m_sessions   = 0;
+    uint64_t       m_badChunks  = 0;
+    bool           m_truncated  = false;
+    std::string    m_lastError;
+};
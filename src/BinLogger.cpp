@@ -0,0 +1,98 @@
+// ============================================================
+//  Protek506Logger — BinLogger.cpp
+// ============================================================
+#include "BinLogger.h"
+#include <cmath>
+#include <limits>
+
+using namespace binlog;
+
+static void ResetFooter(Footer& f)
+{
+    memset(&f, 0, sizeof(f));
+    memcpy(f.magic, kFooterMagic, sizeof(f.magic));
+    f.checksum = Checksum(nullptr, 0);
+    f.minValue = std::numeric_limits<double>::quiet_NaN();
+    f.maxValue = f.minValue;
+}
+
+BinLogger::BinLogger() { ResetFooter(m_chunk); }
+BinLogger::~BinLogger() { Close(); }
+
+bool BinLogger::Open(const std::string& filePath)
+{
+    Close();
+    ResetFooter(m_chunk);
+    m_inSession = false;
+    return m_file.Open(filePath, "ab");
+}
+
+void BinLogger::Close()
+{
+    if (!m_file.IsOpen()) return;
+    if (m_chunk.count > 0)
+        WriteFooter();
+    m_file.Close();
+}
+
+bool BinLogger::WriteHeader(int64_t wallAnchorUs, int64_t monoAnchorUs)
+{
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, kHeaderMagic, sizeof(h.magic));
+    h.version      = kVersion;
+    h.slotSize     = static_cast<uint16_t>(kSlotSize);
+    h.chunkRecords = kChunkRecords;
+    h.wallAnchorUs = wallAnchorUs;
+    h.monoAnchorUs = monoAnchorUs;
+    if (!m_file.Write(&h, sizeof(h)))
+        return false;
+    m_inSession      = true;
+    m_anchorOffsetUs = wallAnchorUs - monoAnchorUs;
+    return true;
+}
+
+bool BinLogger::WriteFooter()
+{
+    if (!m_file.Write(&m_chunk, sizeof(m_chunk)))
+        return false;
+    ResetFooter(m_chunk);
+    return true;
+}
+
+void BinLogger::Write(const DmmSample& s)
+{
+    if (!m_file.IsOpen()) return;
+
+    // Readings carry wallUs = monoUs + their AcqClock's offset.  The
+    // session header takes the first reading's, so the wall times read
+    // back are the ones the CSV would show; a new offset starts a session.
+    if (!m_inSession || s.wallUs - s.monoUs != m_anchorOffsetUs)
+    {
+        if (m_chunk.count > 0 && !WriteFooter())
+            return;
+        if (!WriteHeader(s.wallUs, s.monoUs))
+            return;
+    }
+
+    uint8_t r[kRecordMax];
+    size_t  len = ToRecord(s, r);
+    if (!m_file.Write(r, len))
+        return;
+
+    // Fold the record into the running chunk footer
+    if (m_chunk.count == 0)
+        m_chunk.firstMonoUs = s.monoUs;
+    m_chunk.lastMonoUs = s.monoUs;
+    m_chunk.checksum   = Checksum(r, len, m_chunk.checksum);
+    m_chunk.bytes     += static_cast<uint32_t>(len);
+    if (!std::isnan(s.value))
+    {
+        if (std::isnan(m_chunk.minValue) || s.value < m_chunk.minValue) m_chunk.minValue = s.value;
+        if (std::isnan(m_chunk.maxValue) || s.value > m_chunk.maxValue) m_chunk.maxValue = s.value;
+    }
+    if (++m_chunk.count == kChunkRecords && !WriteFooter())
+        return;
+
+    m_file.RowWritten();
+}
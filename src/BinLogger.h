@@ -0,0 +1,57 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — BinLogger.h
+//  Writes readings to a binary session log (*.p506): each
+//  reading's typed head and raw line, with a session header and
+//  a footer after every chunk (see BinLogFormat.h).  About 35
+//  bytes a reading: 605 simulator readings took 21,311 bytes,
+//  against 31,281 for the CSV with microsecond times (68%) and
+//  28,256 with tenths (75%).  Readable back with a memory map
+//  (BinLogReader) or converted with the p506tocsv tool.
+//
+//  Buffering, flush policy, error reporting and counters are the
+//  LogFile's, as in CsvLogger.  An existing file is appended to.
+//  The first reading writes the session header, anchored on the
+//  reading's own clock; another follows whenever that anchor
+//  changes (a reconnect).  A session with no readings leaves
+//  nothing in the file.
+// ============================================================
+#include <cstdint>
+#include <string>
+#include "SampleLog.h"
+#include "LogFile.h"
+#include "BinLogFormat.h"
+
+class BinLogger : public SampleLog
+{
+public:
+    BinLogger();
+    ~BinLogger();
+
+    bool Open(const std::string& filePath) override;
+    void Close() override;      // writes the last footer and flushes
+    bool IsOpen() const override { return m_file.IsOpen(); }
+
+    void SetFlushPolicy(const LogFlushPolicy& policy) override { m_file.SetFlushPolicy(policy); }
+
+    void Write(const DmmSample& s) override;
+    void Tick() override { m_file.Tick(); }
+    bool Flush() override { return m_file.Flush(); }
+
+    bool        WriteOk()   const override { return m_file.WriteOk(); }
+    std::string LastError() const override { return m_file.LastError(); }
+
+    long     RowCount()     const override { return m_file.RowCount(); }
+    uint64_t BytesWritten() const override { return m_file.BytesWritten(); }
+    uint64_t FlushCount()   const override { return m_file.FlushCount(); }
+    int64_t  WorstFlushUs() const override { return m_file.WorstFlushUs(); }
+
+private:
+    bool WriteHeader(int64_t wallAnchorUs, int64_t monoAnchorUs);
+    bool WriteFooter();
+
+    LogFile           m_file;
+    binlog::Footer    m_chunk;         // footer of the chunk being written
+    bool              m_inSession      = false; // a header has been written since Open()
+    int64_t           m_anchorOffsetUs = 0;     // wall - mono of the last header
+};
@@ -3,16 +3,15 @@
 // ============================================================
 #include "CsvLogger.h"
 #include <sys/stat.h>
+#include <cstring>
 
-CsvLogger::CsvLogger() : m_rowCount(0), m_writeOk(true) {}
+CsvLogger::CsvLogger() {}
 CsvLogger::~CsvLogger() { Close(); }
 
 bool CsvLogger::Open(const std::string& filePath)
 {
     Close();
     m_filePath = filePath;
-    m_rowCount = 0;
-    m_writeOk  = true;
 
     // Check if file exists and is non-empty
     bool needHeader = true;
@@ -20,37 +19,25 @@ bool CsvLogger::Open(const std::string& filePath)
     if (stat(filePath.c_str(), &st) == 0 && st.st_size > 0)
         needHeader = false;
 
-    m_file.open(filePath, std::ios::app);
-    if (!m_file.is_open())
-    {
-        m_lastError = "Cannot open file: " + filePath;
-        m_writeOk   = false;
+    if (!m_file.Open(filePath, "a"))
         return false;
-    }
 
     if (needHeader)
-        m_file << "date,time,mode,reading,units,raw\n";
-
-    m_file.flush();
-    if (m_file.fail())
     {
-        m_lastError = "Write error on header flush (disk full?)";
-        m_writeOk   = false;
-        m_file.close();
-        return false;
+        static const char header[] = "date,time,mode,reading,units,raw\n";
+        m_file.Write(header, sizeof(header) - 1);
     }
-    return true;
+    return m_file.Flush();
 }
 
 void CsvLogger::Close()
 {
-    if (m_file.is_open())
-        m_file.close();
+    m_file.Close();
 }
 
 bool CsvLogger::IsOpen() const
 {
-    return m_file.is_open();
+    return m_file.IsOpen();
 }
 
 void CsvLogger::Write(const std::string& date,
@@ -60,44 +47,65 @@ void CsvLogger::Write(const std::string& date,
                       const std::string& units,
                       const std::string& rawLine)
 {
-    if (!m_file.is_open()) return;
+    if (!m_file.IsOpen()) return;
 
-    m_file << Escape(date)    << ","
-           << Escape(time)    << ","
-           << Escape(mode)    << ","
-           << Escape(reading) << ","
-           << Escape(units)   << ","
-           << Escape(rawLine) << "\n";
-    m_file.flush();
+    m_row.clear();
+    AppendEscaped(m_row, date);    m_row += ',';
+    AppendEscaped(m_row, time);    m_row += ',';
+    AppendEscaped(m_row, mode);    m_row += ',';
+    AppendEscaped(m_row, reading); m_row += ',';
+    AppendEscaped(m_row, units);   m_row += ',';
+    AppendEscaped(m_row, rawLine); m_row += '\n';
+    WriteRow();
+}
 
-    // fix #12: Detect write failure (e.g. disk full) after each row.
-    // Close the file so IsOpen() returns false, letting the caller know
-    // logging has silently stopped.
-    if (m_file.fail())
-    {
-        m_lastError = "Write error (disk full or I/O error)";
-        m_writeOk   = false;
-        m_file.close();
-        return;
-    }
+// v1.6.0: the same columns straight from a sample, for the writer
+// thread; MainFrame's table shows the same strings.  The row is built
+// in m_row, which keeps its capacity, so a row allocates nothing.
+void CsvLogger::Write(const DmmSample& s)
+{
+    if (!m_file.IsOpen()) return;
+
+    char stamp[TimestampFormatter::kTimeMax];
+    m_row.clear();
+    m_row.append(stamp, m_timeFmt.Date(s.wallUs, stamp));  m_row += ',';
+    m_row.append(stamp, m_timeFmt.Time(s.wallUs, stamp));  m_row += ',';
+
+    int valueLen = 0, unitsLen = 0;
+    const char* mode  = DmmModeName(s.mode);
+    const char* value = DmmValueText(s, valueLen);
+    const char* units = DmmUnitsText(s, unitsLen);
+    AppendEscaped(m_row, mode, strlen(mode));                         m_row += ',';
+    AppendEscaped(m_row, value, static_cast<size_t>(valueLen));       m_row += ',';
+    AppendEscaped(m_row, units, static_cast<size_t>(unitsLen));       m_row += ',';
+    AppendEscaped(m_row, s.raw, s.rawLen);                            m_row += '\n';
+    WriteRow();
+}
 
-    ++m_rowCount;
+// Write m_row and apply the flush policy
+void CsvLogger::WriteRow()
+{
+    if (m_file.Write(m_row.data(), m_row.size()))
+        m_file.RowWritten();
 }
 
-std::string CsvLogger::Escape(const std::string& field)
+void CsvLogger::AppendEscaped(std::string& out, const char* field, size_t len)
 {
     // If the field contains comma, quote, or newline — wrap in double-quotes
-    bool needsQuote = (field.find(',')  != std::string::npos ||
-                       field.find('"')  != std::string::npos ||
-                       field.find('\n') != std::string::npos);
-    if (!needsQuote) return field;
+    bool needsQuote = false;
+    for (size_t i = 0; i < len && !needsQuote; ++i)
+        needsQuote = field[i] == ',' || field[i] == '"' || field[i] == '\n';
+    if (!needsQuote)
+    {
+        out.append(field, len);
+        return;
+    }
 
-    std::string out = "\"";
-    for (char c : field)
+    out += '"';
+    for (size_t i = 0; i < len; ++i)
     {
-        if (c == '"') out += "\"\""; // escape embedded quotes
-        else          out += c;
+        if (field[i] == '"') out += "\"\""; // escape embedded quotes
+        else                 out += field[i];
     }
-    out += "\"";
-    return out;
+    out += '"';
 }
@@ -7,19 +7,42 @@
 //
 //  v1.4.0: Added 'raw' column — the verbatim ASCII line received
 //  from the meter (CR stripped) before any parsing.
+//
+//  v1.6.0: rows go into a LogFile (64 KiB stdio buffer) and are
+//  flushed according to a LogFlushPolicy (every N rows and/or
+//  every T ms, plus an optional fdatasync on a timer) instead of
+//  after every row.  Call Tick() periodically so time-based
+//  flushes happen while no rows are arriving.  A write error is
+//  only seen when the buffer is flushed, so WriteOk() may turn
+//  false on Tick() or Flush() as well as on Write().
+//
+//  The time column is tenths of a second by default; SetTimeFormat()
+//  selects milliseconds or microseconds.  Write(const DmmSample&)
+//  builds the row in place: date and time from a cached
+//  TimestampFormatter, the other fields straight from the sample,
+//  no temporary strings.
 // ============================================================
+#include <cstdint>
 #include <string>
-#include <fstream>
+#include "SampleLog.h"
+#include "LogFile.h"
+#include "TimestampFormatter.h"
 
-class CsvLogger
+class CsvLogger : public SampleLog
 {
 public:
     CsvLogger();
     ~CsvLogger();
 
-    bool Open(const std::string& filePath);
-    void Close();
-    bool IsOpen() const;
+    bool Open(const std::string& filePath) override;
+    void Close() override;      // flushes first
+    bool IsOpen() const override;
+
+    void SetFlushPolicy(const LogFlushPolicy& policy) override { m_file.SetFlushPolicy(policy); }
+    const LogFlushPolicy& FlushPolicy() const { return m_file.FlushPolicy(); }
+
+    // Resolution of the time column of Write(const DmmSample&)
+    void SetTimeFormat(LogTimeFormat format) { m_timeFmt.SetFormat(format); }
 
     void Write(const std::string& date,
                const std::string& time,
@@ -28,21 +51,42 @@ public:
                const std::string& units,
                const std::string& rawLine = "");
 
+    // Log a sample: date and time from wallUs, then mode, value, units
+    // and the raw line as the GUI shows them.
+    void Write(const DmmSample& s) override;
+
+    // Apply the time-based parts of the policy.  Cheap when nothing is
+    // due; call it from a timer and after each batch of rows.
+    void Tick() override { m_file.Tick(); }
+
+    // Push buffered rows to the OS now.  Returns WriteOk().
+    bool Flush() override { return m_file.Flush(); }
+
     // fix #12: Returns false if the last Write() failed (e.g. disk full).
     // The file is closed on error; IsOpen() will return false afterward.
-    bool WriteOk() const { return m_writeOk; }
+    bool WriteOk() const override { return m_file.WriteOk(); }
 
     std::string FilePath()  const { return m_filePath; }
-    std::string LastError() const { return m_lastError; }
-    long        RowCount()  const { return m_rowCount; }
+    std::string LastError() const override { return m_file.LastError(); }
+    long        RowCount()  const override { return m_file.RowCount(); }
+
+    // Counters since Open()
+    uint64_t BytesWritten() const override { return m_file.BytesWritten(); }
+    uint64_t FlushCount()   const override { return m_file.FlushCount(); }
+    int64_t  WorstFlushUs() const override { return m_file.WorstFlushUs(); }
 
 private:
-    std::ofstream m_file;
-    std::string   m_filePath;
-    std::string   m_lastError;
-    long          m_rowCount;
-    bool          m_writeOk;   // fix #12: tracks post-open write health
-
-    // CSV-escape a field (wrap in quotes if needed)
-    static std::string Escape(const std::string& field);
+    LogFile            m_file;
+    std::string        m_row;           // reused row assembly buffer
+    std::string        m_filePath;
+    TimestampFormatter m_timeFmt;       // writer thread's date / time cache
+
+    void WriteRow();
+
+    // CSV-escape a field (wrap in quotes if needed) onto 'out'
+    static void AppendEscaped(std::string& out, const char* field, size_t len);
+    static void AppendEscaped(std::string& out, const std::string& field)
+    {
+        AppendEscaped(out, field.data(), field.size());
+    }
 };
@@ -0,0 +1,106 @@
+// ============================================================
+//  Protek506Logger — DiagnosticsDialog.cpp
+// ============================================================
+#include "DiagnosticsDialog.h"
+#include <wx/filedlg.h>
+#include <wx/msgdlg.h>
+#include <wx/sizer.h>
+
+enum { COL_STAGE, COL_COUNT, COL_MEAN, COL_P50, COL_P90, COL_P99, COL_MAX };
+
+// 850 us, 12.3 ms, 1.25 s
+static wxString FormatUs(double us)
+{
+    if (us < 1000.0)    return wxString::Format("%.0f us", us);
+    if (us < 1000000.0) return wxString::Format("%.1f ms", us / 1000.0);
+    return wxString::Format("%.2f s", us / 1000000.0);
+}
+
+DiagnosticsDialog::DiagnosticsDialog(wxWindow* parent, LatencyStats& stats)
+    : wxDialog(parent, wxID_ANY, "Diagnostics", wxDefaultPosition, wxSize(760, 330),
+               wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER)
+    , m_stats(stats)
+    , m_timer(this)
+{
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+
+    sizer->Add(new wxStaticText(this, wxID_ANY,
+                   "Latency per stage, from the meter to the screen and the log file:"),
+               0, wxALL, 8);
+
+    m_list = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                            wxLC_REPORT | wxLC_HRULES | wxLC_VRULES);
+    m_list->InsertColumn(COL_STAGE, "Stage",  wxLIST_FORMAT_LEFT,  290);
+    m_list->InsertColumn(COL_COUNT, "Count",  wxLIST_FORMAT_RIGHT, 70);
+    m_list->InsertColumn(COL_MEAN,  "Mean",   wxLIST_FORMAT_RIGHT, 72);
+    m_list->InsertColumn(COL_P50,   "P50",    wxLIST_FORMAT_RIGHT, 72);
+    m_list->InsertColumn(COL_P90,   "P90",    wxLIST_FORMAT_RIGHT, 72);
+    m_list->InsertColumn(COL_P99,   "P99",    wxLIST_FORMAT_RIGHT, 72);
+    m_list->InsertColumn(COL_MAX,   "Max",    wxLIST_FORMAT_RIGHT, 72);
+    for (int i = 0; i < LatencyStats::kStages; ++i)
+        m_list->InsertItem(i, LatencyStageText(static_cast<LatencyStage>(i)));
+    sizer->Add(m_list, 1, wxEXPAND | wxLEFT | wxRIGHT, 8);
+
+    wxBoxSizer* buttons = new wxBoxSizer(wxHORIZONTAL);
+    wxButton* reset = new wxButton(this, wxID_ANY, "Reset");
+    wxButton* save  = new wxButton(this, wxID_SAVE, "Save JSON...");
+    buttons->Add(reset, 0, wxRIGHT, 6);
+    buttons->Add(save, 0);
+    buttons->AddStretchSpacer();
+    buttons->Add(new wxButton(this, wxID_CLOSE, "Close"), 0);
+    sizer->Add(buttons, 0, wxEXPAND | wxALL, 8);
+    SetSizer(sizer);
+
+    reset->Bind(wxEVT_BUTTON, &DiagnosticsDialog::OnReset, this);
+    save->Bind(wxEVT_BUTTON, &DiagnosticsDialog::OnSaveJson, this);
+    Bind(wxEVT_BUTTON, [this](wxCommandEvent&) { EndModal(wxID_CLOSE); }, wxID_CLOSE);
+    Bind(wxEVT_TIMER, &DiagnosticsDialog::OnTimer, this);
+
+    UpdateTable();
+    m_timer.Start(1000);
+    Centre();
+}
+
+void DiagnosticsDialog::UpdateTable()
+{
+    for (int i = 0; i < LatencyStats::kStages; ++i)
+    {
+        LatencyHistogram h = m_stats.Snapshot(static_cast<LatencyStage>(i));
+        m_list->SetItem(i, COL_COUNT, wxString::Format("%llu",
+                        static_cast<unsigned long long>(h.count)));
+        if (h.count == 0)
+        {
+            for (int c = COL_MEAN; c <= COL_MAX; ++c)
+                m_list->SetItem(i, c, "-");
+            continue;
+        }
+        m_list->SetItem(i, COL_MEAN, FormatUs(h.MeanUs()));
+        m_list->SetItem(i, COL_P50,  FormatUs(static_cast<double>(h.PercentileUs(0.50))));
+        m_list->SetItem(i, COL_P90,  FormatUs(static_cast<double>(h.PercentileUs(0.90))));
+        m_list->SetItem(i, COL_P99,  FormatUs(static_cast<double>(h.PercentileUs(0.99))));
+        m_list->SetItem(i, COL_MAX,  FormatUs(static_cast<double>(h.maxUs)));
+    }
+}
+
+void DiagnosticsDialog::OnTimer(wxTimerEvent&)
+{
+    UpdateTable();
+}
+
+void DiagnosticsDialog::OnReset(wxCommandEvent&)
+{
+    m_stats.Reset();
+    UpdateTable();
+}
+
+void DiagnosticsDialog::OnSaveJson(wxCommandEvent&)
+{
+    wxFileDialog dlg(this, "Save latency statistics", "", "Protek-506-latency.json",
+                     "JSON files (*.json)|*.json|All files (*.*)|*.*",
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dlg.ShowModal() != wxID_OK) return;
+
+    if (!m_stats.ExportJson(dlg.GetPath().ToStdString()))
+        wxMessageBox("Cannot write " + dlg.GetPath(), "Save Error",
+                     wxOK | wxICON_ERROR, this);
+}
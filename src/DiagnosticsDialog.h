@@ -0,0 +1,27 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — DiagnosticsDialog.h
+//  Help > Diagnostics...: the per-stage latency histograms
+//  (LatencyStats) as a table of count, mean, percentiles and
+//  maximum, refreshed every second.  Reset starts the counts
+//  over; Save JSON... writes every stage with its buckets.
+// ============================================================
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include "LatencyStats.h"
+
+class DiagnosticsDialog : public wxDialog
+{
+public:
+    DiagnosticsDialog(wxWindow* parent, LatencyStats& stats);
+
+private:
+    void UpdateTable();
+    void OnTimer(wxTimerEvent& evt);
+    void OnReset(wxCommandEvent& evt);
+    void OnSaveJson(wxCommandEvent& evt);
+
+    LatencyStats& m_stats;
+    wxListCtrl*   m_list = nullptr;
+    wxTimer       m_timer;
+};
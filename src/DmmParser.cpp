@@ -33,33 +33,301 @@
 //    "TEMP 0802 5 C"      → mode=TEMP,value=0802.5,units=C
 // ============================================================
 #include "DmmParser.h"
-#include <cctype>
-#include <algorithm>
 #include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <charconv>
+#include <limits>
+#include <system_error>
 
 DmmParser::DmmParser() {}
 
+// ----------------------------------------------------------------
+// Small ASCII helpers.  The meter only sends 7-bit ASCII, and these
+// avoid both <cctype>'s locale lookups and any string copies.
+// ----------------------------------------------------------------
+static constexpr char Upper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+static constexpr bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool EqualsNoCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (Upper(a[i]) != Upper(b[i])) return false;
+    return true;
+}
+
+static bool StartsWithNoCase(std::string_view s, std::string_view prefix)
+{
+    return s.size() >= prefix.size() &&
+           EqualsNoCase(s.substr(0, prefix.size()), prefix);
+}
+
+// Offsets of the trimmed part of [begin, end) within the line.
+static void TrimSpan(std::string_view line, size_t& begin, size_t& end)
+{
+    while (begin < end && IsBlank(line[begin]))   ++begin;
+    while (end > begin && IsBlank(line[end - 1])) --end;
+}
+
 // ----------------------------------------------------------------
 // Known mode words (all uppercase, as sent by the meter).
 // The meter always sends a space after the mode word before the
 // value, so we match the token before the first space.
 // ----------------------------------------------------------------
-static const struct { const char* word; const char* friendly; } s_modes[] =
+struct ModeEntry { std::string_view word; const char* friendly; DmmMode mode; };
+
+static constexpr ModeEntry s_modes[] =
 {
-    { "DC",   "DC"          },
-    { "AC",   "AC"          },
-    { "RES",  "RES"         },
-    { "BUZ",  "CONT"        },   // continuity / buzzer
+    { "DC",   "DC",    DmmMode::DC    },
+    { "AC",   "AC",    DmmMode::AC    },
+    { "RES",  "RES",   DmmMode::RES   },
+    { "BUZ",  "CONT",  DmmMode::CONT  },   // continuity / buzzer
     // Some firmware emits "DIO" while others send the full "DIOD".
-    { "DIO",  "DIODE"       },
-    { "DIOD", "DIODE"       },
-    { "LOG",  "LOGIC"       },
-    { "FR",   "FREQ"        },
-    { "CAP",  "CAP"         },
-    { "IND",  "IND"         },
-    { "TEMP", "TEMP"        },
+    { "DIO",  "DIODE", DmmMode::DIODE },
+    { "DIOD", "DIODE", DmmMode::DIODE },
+    { "LOG",  "LOGIC", DmmMode::LOGIC },
+    { "FR",   "FREQ",  DmmMode::FREQ  },
+    { "CAP",  "CAP",   DmmMode::CAP   },
+    { "IND",  "IND",   DmmMode::IND   },
+    { "TEMP", "TEMP",  DmmMode::TEMP  },
 };
-static const int s_modeCount = static_cast<int>(sizeof(s_modes) / sizeof(s_modes[0]));
+static constexpr int s_modeCount = static_cast<int>(sizeof(s_modes) / sizeof(s_modes[0]));
+
+// ----------------------------------------------------------------
+// Units as sent by the meter, with their enum and display text
+// (UTF-8).  The meter sends resistance as "OH", "KOH", "MOH" and
+// temperature as "C" / "F" (older firmware "^C" / "^F"); those are
+// shown as Ω and °C / °F.  Everything else is shown as sent.
+// ----------------------------------------------------------------
+struct UnitEntry
+{
+    std::string_view sent;
+    const char*      text;
+    DmmUnit          unit;
+    DmmUnit          base;      // SI base unit of the same quantity
+    double           scale;     // value * scale = value in 'base'
+};
+
+static constexpr UnitEntry s_units[] =
+{
+    { "V",   "V",             DmmUnit::V,     DmmUnit::V,     1.0  },
+    { "mV",  "mV",            DmmUnit::mV,    DmmUnit::V,     1e-3 },
+    { "A",   "A",             DmmUnit::A,     DmmUnit::A,     1.0  },
+    { "mA",  "mA",            DmmUnit::mA,    DmmUnit::A,     1e-3 },
+    { "uA",  "uA",            DmmUnit::uA,    DmmUnit::A,     1e-6 },
+    { "OH",  "\xce\xa9",      DmmUnit::Ohm,   DmmUnit::Ohm,   1.0  },   // Ω
+    { "KOH", "k\xce\xa9",     DmmUnit::kOhm,  DmmUnit::Ohm,   1e3  },   // kΩ
+    { "MOH", "M\xce\xa9",     DmmUnit::MOhm,  DmmUnit::Ohm,   1e6  },   // MΩ
+    { "Hz",  "Hz",            DmmUnit::Hz,    DmmUnit::Hz,    1.0  },
+    { "kHz", "kHz",           DmmUnit::kHz,   DmmUnit::Hz,    1e3  },
+    { "MHz", "MHz",           DmmUnit::MHz,   DmmUnit::Hz,    1e6  },
+    { "nF",  "nF",            DmmUnit::nF,    DmmUnit::F,     1e-9 },
+    { "uF",  "uF",            DmmUnit::uF,    DmmUnit::F,     1e-6 },
+    { "mH",  "mH",            DmmUnit::mH,    DmmUnit::H,     1e-3 },
+    { "H",   "H",             DmmUnit::H,     DmmUnit::H,     1.0  },
+    { "C",   "\xc2\xb0""C",   DmmUnit::DegC,  DmmUnit::DegC,  1.0  },   // °C
+    { "^C",  "\xc2\xb0""C",   DmmUnit::DegC,  DmmUnit::DegC,  1.0  },
+    { "F",   "\xc2\xb0""F",   DmmUnit::DegF,  DmmUnit::DegF,  1.0  },   // °F
+    { "^F",  "\xc2\xb0""F",   DmmUnit::DegF,  DmmUnit::DegF,  1.0  },
+};
+static constexpr int s_unitCount = static_cast<int>(sizeof(s_units) / sizeof(s_units[0]));
+
+// ----------------------------------------------------------------
+// Perfect hashes over the two tables.
+//
+// Each token hashes on its length, first and last byte into a small
+// power-of-two slot table built at compile time.  The multipliers
+// were chosen so that no two table entries share a slot; the
+// static_asserts re-check that whenever a table is edited.  A lookup
+// is then one hash, one slot read and one compare.
+//
+// Mode words are matched case-insensitively (the old parser upper-
+// cased them), so that hash folds case.  Units are case-sensitive:
+// "mV" and "MV" are different units.
+// ----------------------------------------------------------------
+static constexpr size_t kModeSlots = 16;
+static constexpr size_t kUnitSlots = 32;
+
+static constexpr size_t ModeHash(std::string_view w)
+{
+    return (w.size() + 4u * static_cast<unsigned char>(Upper(w.front())) +
+            9u * static_cast<unsigned char>(Upper(w.back()))) & (kModeSlots - 1);
+}
+
+static constexpr size_t UnitHash(std::string_view u)
+{
+    return (u.size() + 11u * static_cast<unsigned char>(u.front()) +
+            26u * static_cast<unsigned char>(u.back())) & (kUnitSlots - 1);
+}
+
+template <size_t Slots>
+struct SlotTable { int8_t index[Slots]; };
+
+static constexpr bool ModeHashIsPerfect()
+{
+    bool used[kModeSlots] = {};
+    for (const ModeEntry& e : s_modes)
+    {
+        size_t h = ModeHash(e.word);
+        if (used[h]) return false;
+        used[h] = true;
+    }
+    return true;
+}
+
+static constexpr bool UnitHashIsPerfect()
+{
+    bool used[kUnitSlots] = {};
+    for (const UnitEntry& e : s_units)
+    {
+        size_t h = UnitHash(e.sent);
+        if (used[h]) return false;
+        used[h] = true;
+    }
+    return true;
+}
+
+static_assert(ModeHashIsPerfect(), "ModeHash collides; pick new multipliers");
+static_assert(UnitHashIsPerfect(), "UnitHash collides; pick new multipliers");
+
+static constexpr SlotTable<kModeSlots> BuildModeSlots()
+{
+    SlotTable<kModeSlots> t{};
+    for (size_t i = 0; i < kModeSlots; ++i) t.index[i] = -1;
+    for (int i = 0; i < s_modeCount; ++i)
+        t.index[ModeHash(s_modes[i].word)] = static_cast<int8_t>(i);
+    return t;
+}
+
+static constexpr SlotTable<kUnitSlots> BuildUnitSlots()
+{
+    SlotTable<kUnitSlots> t{};
+    for (size_t i = 0; i < kUnitSlots; ++i) t.index[i] = -1;
+    for (int i = 0; i < s_unitCount; ++i)
+        t.index[UnitHash(s_units[i].sent)] = static_cast<int8_t>(i);
+    return t;
+}
+
+static constexpr SlotTable<kModeSlots> s_modeSlots = BuildModeSlots();
+static constexpr SlotTable<kUnitSlots> s_unitSlots = BuildUnitSlots();
+
+// The first s_units entry for each DmmUnit, so the enum → text / base /
+// scale helpers are one index instead of a table walk (BinLogReader
+// calls DmmUnitScale() for every record it reads).
+static constexpr size_t kUnitKinds = static_cast<size_t>(DmmUnit::DegF) + 1;
+
+static constexpr SlotTable<kUnitKinds> BuildUnitIndex()
+{
+    SlotTable<kUnitKinds> t{};
+    for (size_t i = 0; i < kUnitKinds; ++i) t.index[i] = -1;
+    for (int i = s_unitCount - 1; i >= 0; --i)
+        t.index[static_cast<size_t>(s_units[i].unit)] = static_cast<int8_t>(i);
+    return t;
+}
+
+static constexpr SlotTable<kUnitKinds> s_unitIndex = BuildUnitIndex();
+
+static const UnitEntry* UnitOf(DmmUnit unit)
+{
+    size_t u = static_cast<size_t>(unit);
+    int    i = u < kUnitKinds ? s_unitIndex.index[u] : -1;
+    return i < 0 ? nullptr : &s_units[i];
+}
+
+static const ModeEntry* FindMode(std::string_view word)
+{
+    if (word.empty()) return nullptr;
+    int i = s_modeSlots.index[ModeHash(word)];
+    if (i < 0 || !EqualsNoCase(word, s_modes[i].word)) return nullptr;
+    return &s_modes[i];
+}
+
+static const UnitEntry* FindUnit(std::string_view sent)
+{
+    if (sent.empty()) return nullptr;
+    int i = s_unitSlots.index[UnitHash(sent)];
+    if (i < 0 || sent != s_units[i].sent) return nullptr;
+    return &s_units[i];
+}
+
+// ----------------------------------------------------------------
+// Enum → text helpers (declared in DmmParser.h)
+// ----------------------------------------------------------------
+const char* DmmModeName(DmmMode mode)
+{
+    for (const ModeEntry& e : s_modes)
+        if (e.mode == mode)
+            return e.friendly;
+    return "";
+}
+
+const char* DmmUnitText(DmmUnit unit)
+{
+    const UnitEntry* e = UnitOf(unit);
+    return e ? e->text : "";
+}
+
+DmmUnit DmmBaseUnit(DmmUnit unit)
+{
+    const UnitEntry* e = UnitOf(unit);
+    return e ? e->base : unit;
+}
+
+double DmmUnitScale(DmmUnit unit)
+{
+    const UnitEntry* e = UnitOf(unit);
+    return e ? e->scale : 1.0;
+}
+
+DmmUnit DmmUnitFromText(std::string_view text)
+{
+    if (const UnitEntry* u = FindUnit(text))
+        return u->unit;
+    for (const UnitEntry& e : s_units)
+        if (text == e.text)
+            return e.unit;
+    return DmmUnit::None;
+}
+
+const char* DmmValueText(const DmmSample& s, int& len)
+{
+    const char* text = nullptr;
+    switch (s.kind)
+    {
+        case DmmValueKind::Overload:  text = "OL";    break;
+        case DmmValueKind::Open:      text = "OPEN";  break;
+        case DmmValueKind::Short:     text = "SHORT"; break;
+        case DmmValueKind::Good:      text = "GOOD";  break;
+        case DmmValueKind::High:      text = "High";  break;
+        case DmmValueKind::Low:       text = "Low";   break;
+        case DmmValueKind::Undefined: text = "----";  break;
+        case DmmValueKind::Numeric:
+            len = s.valueLen;
+            return s.raw + s.valueOff;
+    }
+    len = static_cast<int>(strlen(text));
+    return text;
+}
+
+const char* DmmUnitsText(const DmmSample& s, int& len)
+{
+    if (s.unit == DmmUnit::Other)
+    {
+        len = s.unitLen;
+        return s.raw + s.unitOff;
+    }
+    const char* text = DmmUnitText(s.unit);
+    len = static_cast<int>(strlen(text));
+    return text;
+}
 
 // ----------------------------------------------------------------
 // IsKnownModeCode — kept for API compatibility; tests the first
@@ -69,7 +337,13 @@ bool DmmParser::IsKnownModeCode(char c)
 {
     // First chars of all known mode words
     static const char* firsts = "DARBLFCIT";
-    return strchr(firsts, static_cast<unsigned char>(c)) != nullptr;
+    return c != '\0' && strchr(firsts, static_cast<unsigned char>(c)) != nullptr;
+}
+
+DmmMode DmmParser::ModeOf(std::string_view word)
+{
+    const ModeEntry* e = FindMode(word);
+    return e ? e->mode : DmmMode::Unknown;
 }
 
 // ----------------------------------------------------------------
@@ -77,120 +351,124 @@ bool DmmParser::IsKnownModeCode(char c)
 // ----------------------------------------------------------------
 std::string DmmParser::MapMode(const std::string& word) const
 {
-    for (int i = 0; i < s_modeCount; ++i)
-        if (word == s_modes[i].word)
-            return s_modes[i].friendly;
-    return word;   // pass-through for unknown/future modes
+    const ModeEntry* e = FindMode(word);
+    return e ? std::string(e->friendly) : word;   // pass-through for unknown/future modes
 }
 
 // ----------------------------------------------------------------
-// Helpers
+// ClassifyValue
+// Recognises the special value tokens (case-insensitive), as the old
+// lower-cased substring tests did.  "0L" is accepted for "OL": the
+// seven-segment overload glyph is sometimes sent with a zero.
 // ----------------------------------------------------------------
-static std::string Trim(const std::string& s)
+static DmmValueKind ClassifyValue(std::string_view v)
 {
-    size_t start = s.find_first_not_of(" \t\r\n");
-    if (start == std::string::npos) return "";
-    size_t end = s.find_last_not_of(" \t\r\n");
-    return s.substr(start, end - start + 1);
+    if (StartsWithNoCase(v, "OL") || StartsWithNoCase(v, "0L"))
+        return DmmValueKind::Overload;
+    if (EqualsNoCase(v, "OPEN"))  return DmmValueKind::Open;
+    if (EqualsNoCase(v, "SHORT")) return DmmValueKind::Short;
+    if (EqualsNoCase(v, "GOOD"))  return DmmValueKind::Good;
+    if (EqualsNoCase(v, "HIGH") || EqualsNoCase(v, "HI")) return DmmValueKind::High;
+    if (EqualsNoCase(v, "LOW")  || EqualsNoCase(v, "LO")) return DmmValueKind::Low;
+    if (v.find("----") != std::string_view::npos) return DmmValueKind::Undefined;
+    return DmmValueKind::Numeric;
 }
 
-static std::string ToUpper(std::string s)
+// ----------------------------------------------------------------
+// DecodeNumber
+// Converts a whole value token to a double, or NaN if it is not
+// entirely a number.  std::from_chars is used where the library has
+// the floating-point overload: no locale, no NUL terminator, no copy.
+//
+// The meter reports temperature with a space where the decimal point
+// belongs ("TEMP 0802 5 C" is 802.5 °C); that one form is rewritten
+// to a '.' in a stack buffer before conversion.
+// ----------------------------------------------------------------
+static double DecodeNumber(std::string_view v)
 {
-    std::transform(s.begin(), s.end(), s.begin(),
-                   [](unsigned char c){ return std::toupper(c); });
-    return s;
-}
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    char buf[DmmSample::kRawMax + 1];
+    if (v.empty() || v.size() > static_cast<size_t>(DmmSample::kRawMax)) return nan;
 
-static std::string ToLower(std::string s)
-{
-    std::transform(s.begin(), s.end(), s.begin(),
-                   [](unsigned char c){ return std::tolower(c); });
-    return s;
+    size_t sp = v.find(' ');
+    if (sp != std::string_view::npos)
+    {
+        if (sp == 0 || sp + 1 == v.size() ||
+            v.find(' ', sp + 1) != std::string_view::npos ||
+            v.find('.') != std::string_view::npos)
+            return nan;
+        memcpy(buf, v.data(), v.size());
+        buf[sp] = '.';
+        v = std::string_view(buf, v.size());
+    }
+
+    // Neither from_chars nor the meter need an explicit '+'
+    if (v[0] == '+') v.remove_prefix(1);
+    if (v.empty()) return nan;
+
+#if defined(__cpp_lib_to_chars)
+    double d = 0.0;
+    auto res = std::from_chars(v.data(), v.data() + v.size(), d);
+    return (res.ec == std::errc() && res.ptr == v.data() + v.size()) ? d : nan;
+#else
+    // Older standard libraries: strtod needs a NUL-terminated copy
+    char tmp[DmmSample::kRawMax + 1];
+    memcpy(tmp, v.data(), v.size());
+    tmp[v.size()] = '\0';
+    char* end = nullptr;
+    double d  = strtod(tmp, &end);
+    return (end && *end == '\0') ? d : nan;
+#endif
 }
 
 // ----------------------------------------------------------------
 // ParseValueAndUnits
-// Receives the part of the line AFTER the mode-word-plus-space has
-// been removed.  Splits on the last space to separate value from
-// units; handles all special tokens (OL, SHORT, OPEN, etc.).
+// Receives the span of the line AFTER the mode-word-plus-space.
+// Splits on the last space to separate value from units; handles all
+// special tokens (OL, SHORT, OPEN, etc.).  Works on offsets into the
+// sample's raw buffer, so nothing is copied.
 // ----------------------------------------------------------------
-void DmmParser::ParseValueAndUnits(const std::string& rest, DmmReading& out) const
+void DmmParser::ParseValueAndUnits(size_t begin, size_t end, DmmSample& out) const
 {
-    std::string r = Trim(rest);
-    if (r.empty()) return;
+    std::string_view line(out.raw, out.rawLen);
+    TrimSpan(line, begin, end);
+    if (begin == end) return;
 
     // Split: value = everything up to last space, units = last token.
     // For readings with no units (OL, SHORT, OPEN, HIGH, LOW, ----)
     // there will be no space, so the whole string is the value.
-    size_t lastSpace = r.find_last_of(' ');
-    if (lastSpace != std::string::npos && lastSpace < r.size() - 1)
+    size_t valBegin = begin, valEnd = end;
+    size_t lastSpace = line.substr(0, end).find_last_of(' ');
+    if (lastSpace != std::string_view::npos && lastSpace >= begin &&
+        lastSpace < end - 1)
     {
-        std::string valPart  = Trim(r.substr(0, lastSpace));
-        std::string unitPart = Trim(r.substr(lastSpace + 1));
-
-        // Normalise temperature unit notations
-        if (unitPart == "^C" || unitPart == "C")  unitPart = "\xc2\xb0""C";  // °C (UTF-8)
-        if (unitPart == "^F" || unitPart == "F")  unitPart = "\xc2\xb0""F";  // °F (UTF-8)
+        size_t unitBegin = lastSpace + 1, unitEnd = end;
+        valEnd = lastSpace;
+        TrimSpan(line, valBegin, valEnd);
+        TrimSpan(line, unitBegin, unitEnd);
 
-        // The meter sends resistance units as "OH", "KOH", "MOH".
-        // Map to readable Ω forms.
-        if (unitPart == "OH")  unitPart = "\xce\xa9";         // Ω
-        if (unitPart == "KOH") unitPart = "k\xce\xa9";        // kΩ
-        if (unitPart == "MOH") unitPart = "M\xce\xa9";        // MΩ
-
-        out.rawValue = valPart;
-        out.units    = unitPart;
-    }
-    else
-    {
-        // No space — entire string is a bare token (OL, SHORT, etc.)
-        out.rawValue = r;
-        out.units    = "";
+        std::string_view unit = line.substr(unitBegin, unitEnd - unitBegin);
+        const UnitEntry* u = FindUnit(unit);
+        out.unit    = u ? u->unit : DmmUnit::Other;
+        out.unitOff = static_cast<uint8_t>(unitBegin);
+        out.unitLen = static_cast<uint8_t>(unitEnd - unitBegin);
     }
 
-    // Classify special values (case-insensitive substring match)
-    std::string v_lower = ToLower(out.rawValue);
+    out.valueOff = static_cast<uint8_t>(valBegin);
+    out.valueLen = static_cast<uint8_t>(valEnd - valBegin);
 
-    if (v_lower == "ol" || v_lower.find("ol") == 0)
-    {
-        out.isOverload = true;
-        out.rawValue   = "OL";
-        out.units      = "";
-    }
-    else if (v_lower == "open")
+    std::string_view value = line.substr(valBegin, valEnd - valBegin);
+    out.kind = ClassifyValue(value);
+    if (out.kind == DmmValueKind::Numeric)
     {
-        out.isOpen   = true;
-        out.rawValue = "OPEN";
-        out.units    = "";
+        out.value  = DecodeNumber(value);
+        out.scaled = out.value * DmmUnitScale(out.unit);
     }
-    else if (v_lower == "short")
-    {
-        out.isShort  = true;
-        out.rawValue = "SHORT";
-        out.units    = "";
-    }
-    else if (v_lower == "good")
-    {
-        out.rawValue = "GOOD";
-        out.units    = "";
-    }
-    else if (v_lower == "high" || v_lower == "hi")
-    {
-        out.isLogicHigh = true;
-        out.rawValue    = "High";
-        out.units       = "";
-    }
-    else if (v_lower == "low" || v_lower == "lo")
-    {
-        out.isLogicLow = true;
-        out.rawValue   = "Low";
-        out.units      = "";
-    }
-    else if (v_lower.find("----") != std::string::npos)
+    else
     {
-        out.isLogicUndef = true;
-        out.rawValue     = "----";
-        out.units        = "";
+        // Special values never carry units
+        out.unit    = DmmUnit::None;
+        out.unitLen = 0;
     }
 }
 
@@ -205,52 +483,82 @@ void DmmParser::ParseValueAndUnits(const std::string& rest, DmmReading& out) con
 //   "TEMP 0802 5 C"
 //
 // Algorithm:
-//   1. Trim the line.
+//   1. Copy the line into the sample's raw buffer and trim it.
 //   2. Find the first space — everything before it is the mode word.
 //   3. Look up the mode word; reject the line if unknown.
 //   4. Pass everything after the mode word + space to ParseValueAndUnits.
+//
+// v1.6.0: works on a string_view and fills a DmmSample in place — no
+// std::string is created.  Lines longer than DmmSample::kRawMax cannot
+// be a Protek reading and are rejected.
 // ----------------------------------------------------------------
-DmmReading DmmParser::Parse(const std::string& line)
+bool DmmParser::Parse(std::string_view line, DmmSample& out) const
 {
-    DmmReading out;
-    out.rawLine = line;
+    out = DmmSample();
+    out.value  = std::numeric_limits<double>::quiet_NaN();
+    out.scaled = out.value;
+    if (line.size() > static_cast<size_t>(DmmSample::kRawMax)) return false;
+
+    memcpy(out.raw, line.data(), line.size());
+    out.rawLen = static_cast<uint8_t>(line.size());
+    std::string_view raw(out.raw, out.rawLen);
 
-    std::string clean = Trim(line);
-    if (clean.empty()) return out;
+    size_t begin = 0, end = raw.size();
+    TrimSpan(raw, begin, end);
+    if (begin == end) return false;
 
     // Quick first-character check to skip obvious non-readings cheaply
-    if (!IsKnownModeCode(clean[0])) return out;
+    if (!IsKnownModeCode(raw[begin])) return false;
 
     // Split mode word from the rest at the first space
-    size_t spacePos = clean.find(' ');
-    if (spacePos == std::string::npos)
+    size_t spacePos = raw.substr(0, end).find(' ', begin);
+    if (spacePos == std::string_view::npos)
     {
         // No space at all — line is just a mode word with no value.
         // Treat as invalid (meter shouldn't send this, but be safe).
-        return out;
+        return false;
     }
 
-    std::string modeWord = ToUpper(clean.substr(0, spacePos));
-    std::string rest     = clean.substr(spacePos + 1);   // value [space units]
+    const ModeEntry* mode = FindMode(raw.substr(begin, spacePos - begin));
+    if (!mode) return false;   // unknown mode word → discard
 
-    // Verify it's a recognised mode word
-    std::string friendly;
-    bool found = false;
-    for (int i = 0; i < s_modeCount; ++i)
-    {
-        if (modeWord == s_modes[i].word)
-        {
-            friendly = s_modes[i].friendly;
-            found    = true;
-            break;
-        }
-    }
-    if (!found) return out;   // unknown mode word → discard
+    out.mode = mode->mode;
+    ParseValueAndUnits(spacePos + 1, end, out);
+    return true;
+}
+
+// ----------------------------------------------------------------
+// Parse (std::string) — thin adapter kept for existing callers.
+// Fills the older string-based DmmReading from the compact sample.
+// ----------------------------------------------------------------
+DmmReading DmmParser::Parse(const std::string& line)
+{
+    DmmReading out;
+    out.rawLine = line;
+
+    DmmSample s;
+    if (!Parse(std::string_view(line), s)) return out;
+
+    // The mode word as sent (upper-cased), e.g. "DIO" vs "DIOD"
+    std::string_view raw(s.raw, s.rawLen);
+    size_t begin = 0, end = raw.size();
+    TrimSpan(raw, begin, end);
+    for (size_t i = begin; i < end && raw[i] != ' '; ++i)
+        out.modeCode += Upper(raw[i]);
 
-    out.valid    = true;
-    out.modeCode = modeWord;
-    out.modeName = friendly;
+    int len = 0;
+    const char* text = DmmValueText(s, len);
+    out.rawValue.assign(text, len);
+    text = DmmUnitsText(s, len);
+    out.units.assign(text, len);
 
-    ParseValueAndUnits(rest, out);
+    out.valid        = true;
+    out.modeName     = DmmModeName(s.mode);
+    out.isOverload   = s.kind == DmmValueKind::Overload;
+    out.isOpen       = s.kind == DmmValueKind::Open;
+    out.isShort      = s.kind == DmmValueKind::Short;
+    out.isLogicHigh  = s.kind == DmmValueKind::High;
+    out.isLogicLow   = s.kind == DmmValueKind::Low;
+    out.isLogicUndef = s.kind == DmmValueKind::Undefined;
     return out;
 }
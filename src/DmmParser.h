@@ -26,6 +26,8 @@
 //  VALUE is a numeric string (e.g. "3.999", "-0.001") or a
 //  special token: "OL" (overload), "SHORT", "OPEN", "HIGH",
 //  "LOW", "GOOD", "----".
+//  Temperature is sent with a space in place of the decimal
+//  point: "TEMP 0802 5 C" is 802.5 °C.
 //
 //  UNITS is a short ASCII string, e.g. "V", "mV", "MOH", "KOH",
 //  "OH", "MHz", "kHz", "uF", "nF", "C", "F".
@@ -35,6 +37,42 @@
 //  Serial settings: 1200 baud, 7 data bits, 2 stop bits, no parity.
 // ============================================================
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <type_traits>
+
+// v1.6.0: enumerated forms of the mode word, units and special value
+// tokens, used by DmmSample below.
+enum class DmmMode : uint8_t
+{
+    Unknown = 0,
+    DC, AC, RES, CONT, DIODE, LOGIC, FREQ, CAP, IND, TEMP
+};
+
+enum class DmmUnit : uint8_t
+{
+    None = 0,
+    Other,              // not in the table; text kept in DmmSample::raw
+    V, mV, A, mA, uA,
+    Ohm, kOhm, MOhm,
+    Hz, kHz, MHz,
+    nF, uF,
+    F,                  // farad; only used as the base of nF / uF
+    mH, H,
+    DegC, DegF
+};
+
+enum class DmmValueKind : uint8_t
+{
+    Numeric = 0,        // plain value token (see DmmSample::value)
+    Overload,           // "OL"
+    Open,               // "OPEN"
+    Short,              // "SHORT"
+    Good,               // "GOOD"
+    High,               // logic "High"
+    Low,                // logic "Low"
+    Undefined           // logic "----"
+};
 
 struct DmmReading
 {
@@ -52,12 +90,77 @@ struct DmmReading
     bool        isLogicUndef = false;
 };
 
+// ----------------------------------------------------------------
+// DmmSample — compact, trivially copyable form of a reading.
+//
+// This is what crosses from the reader thread to the GUI: no strings,
+// no heap.  The value and unit text are not copied; they are spans of
+// the raw line kept inline in 'raw' (which is also what gets logged).
+// Use the helpers below to get display text.
+// ----------------------------------------------------------------
+struct DmmSample
+{
+    static constexpr int kRawMax = 40;   // Protek lines are ~16 bytes
+
+    int64_t      wallUs    = 0;    // monoUs on the wall clock, microseconds since epoch
+    int64_t      monoUs    = 0;    // steady_clock µs: the reply's first byte on the wire (AcqClock)
+    int64_t      triggerUs = 0;    // steady_clock when its trigger was sent (0 if none)
+    int64_t      rxUs      = 0;    // steady_clock when its CR was taken from the port
+    int64_t      queuedUs  = 0;    // steady_clock when queued for the GUI (LatencyStats)
+    double       value    = 0.0;   // numeric reading; NaN if not a number
+    double       scaled   = 0.0;   // value in the SI base unit (12.3 mV → 0.0123 V)
+    DmmMode      mode     = DmmMode::Unknown;
+    DmmUnit      unit     = DmmUnit::None;
+    DmmValueKind kind     = DmmValueKind::Numeric;
+    uint8_t      rawLen   = 0;
+    uint8_t      valueOff = 0;     // value token within raw
+    uint8_t      valueLen = 0;
+    uint8_t      unitOff  = 0;     // unit token within raw (as sent)
+    uint8_t      unitLen  = 0;
+    char         raw[kRawMax] = {};
+};
+static_assert(std::is_trivially_copyable<DmmSample>::value,
+              "DmmSample must stay trivially copyable");
+
+// Friendly short mode name, e.g. DmmMode::FREQ → "FREQ" (same strings
+// as DmmReading::modeName).
+const char* DmmModeName(DmmMode mode);
+
+// Display text for a unit (UTF-8), e.g. DmmUnit::kOhm → "kΩ".
+// Returns "" for None and Other.
+const char* DmmUnitText(DmmUnit unit);
+
+// v1.6.0: SI base unit of a unit's quantity and the factor that takes a
+// value there, e.g. DmmUnit::mV → DmmUnit::V and 1e-3.  Temperatures are
+// their own base.  None / Other are returned unchanged with scale 1.
+DmmUnit DmmBaseUnit(DmmUnit unit);
+double  DmmUnitScale(DmmUnit unit);
+
+// v1.6.0: unit for a token as the meter sends it ("mV", "KOH") or as
+// DmmUnitText() shows it ("kΩ").  None if neither matches.
+DmmUnit DmmUnitFromText(std::string_view text);
+
+// Display text of the value: the normalised token for special values
+// ("OL", "High", ...) or the digits exactly as the meter sent them.
+// The result points into the sample or a static string; it is not
+// NUL-terminated for numeric values, hence the length out-parameter.
+const char* DmmValueText(const DmmSample& s, int& len);
+
+// Display text of the units; for DmmUnit::Other the token as sent.
+const char* DmmUnitsText(const DmmSample& s, int& len);
+
 class DmmParser
 {
 public:
     DmmParser();
 
-    // Parse a raw line (CR terminator already stripped) from the meter.
+    // Parse a raw line (CR terminator already stripped) from the meter
+    // into 'out' without allocating.  Returns false if the line is not
+    // a reading (out is then unspecified).  Timestamps are left at zero
+    // for the caller to fill in.
+    bool Parse(std::string_view line, DmmSample& out) const;
+
+    // String-based form of the above, kept for existing callers.
     // Returns a DmmReading; check .valid before using.
     DmmReading Parse(const std::string& line);
 
@@ -66,8 +169,14 @@ public:
     static bool IsKnownModeCode(char c);
 
 private:
+    friend class DmmStreamParser;   // shares the mode lookup and value/unit split
+
+    // Mode for a mode word (case-insensitive); Unknown if not a mode word.
+    static DmmMode ModeOf(std::string_view word);
+
     // Returns the friendly display name for a mode word, e.g. "FR" → "FREQ".
     std::string MapMode(const std::string& word) const;
 
-    void ParseValueAndUnits(const std::string& rest, DmmReading& out) const;
+    // Fill value and unit fields from raw[begin, end) of 'out'.
+    void ParseValueAndUnits(size_t begin, size_t end, DmmSample& out) const;
 };
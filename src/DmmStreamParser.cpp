@@ -0,0 +1,143 @@
+// ============================================================
+//  Protek506Logger — DmmStreamParser.cpp
+// ============================================================
+#include "DmmStreamParser.h"
+#include <limits>
+
+// ----------------------------------------------------------------
+// Byte classes and states
+// ----------------------------------------------------------------
+enum : uint8_t { K_SPACE, K_CR, K_LF, K_TEXT, K_BAD, K_COUNT };
+
+enum : uint8_t
+{
+    S_IDLE,         // between frames; blanks and stray LFs ignored
+    S_MODE,         // inside the mode word
+    S_GAP,          // blanks after the mode word or a token
+    S_TOKEN,        // inside a value or unit token
+    S_SKIP,         // garbled frame: wait for the next CR
+    S_COUNT
+};
+
+enum : uint8_t
+{
+    A_NONE,         // just change state
+    A_BEGIN,        // first byte of a frame
+    A_STORE,        // append to the raw line
+    A_MODE_END,     // blank after the mode word: look the word up
+    A_TOKEN,        // first byte of a value / unit token
+    A_EMIT,         // CR: finish the sample
+    A_REJECT        // not a reading: count it, then go to 'next'
+};
+
+struct Transition { uint8_t next; uint8_t action; };
+
+static constexpr Transition s_table[S_COUNT][K_COUNT] =
+{
+    //              K_SPACE              K_CR                  K_LF                  K_TEXT                K_BAD
+    /* S_IDLE  */ { {S_IDLE,  A_NONE },  {S_IDLE, A_NONE  },  {S_IDLE, A_NONE  },  {S_MODE,  A_BEGIN},  {S_SKIP, A_REJECT} },
+    /* S_MODE  */ { {S_GAP,   A_MODE_END},{S_IDLE, A_REJECT},  {S_SKIP, A_REJECT},  {S_MODE,  A_STORE},  {S_SKIP, A_REJECT} },
+    /* S_GAP   */ { {S_GAP,   A_STORE},  {S_IDLE, A_EMIT  },  {S_SKIP, A_REJECT},  {S_TOKEN, A_TOKEN},  {S_SKIP, A_REJECT} },
+    /* S_TOKEN */ { {S_GAP,   A_STORE},  {S_IDLE, A_EMIT  },  {S_SKIP, A_REJECT},  {S_TOKEN, A_STORE},  {S_SKIP, A_REJECT} },
+    /* S_SKIP  */ { {S_SKIP,  A_NONE },  {S_IDLE, A_NONE  },  {S_SKIP, A_NONE  },  {S_SKIP,  A_NONE },  {S_SKIP, A_NONE  } },
+};
+
+struct ClassTable { uint8_t k[256]; };
+
+static constexpr ClassTable BuildClasses()
+{
+    ClassTable t{};
+    for (int c = 0; c < 256; ++c)
+        t.k[c] = (c > 0x20 && c < 0x7f) ? K_TEXT : K_BAD;
+    t.k[' ']  = K_SPACE;
+    t.k['\t'] = K_SPACE;
+    t.k['\r'] = K_CR;
+    t.k['\n'] = K_LF;
+    return t;
+}
+static constexpr ClassTable s_class = BuildClasses();
+
+// A value is one token, or two for the "0802 5" temperature form; a
+// unit is one more.  Anything beyond that is two frames run together.
+static const uint8_t MAX_TOKENS = 3;
+
+// ----------------------------------------------------------------
+// DmmStreamParser
+// ----------------------------------------------------------------
+DmmStreamParser::DmmStreamParser() : m_garbled(0) {}
+
+void DmmStreamParser::Reset()
+{
+    if (m_state != S_IDLE && m_state != S_SKIP)
+        m_garbled.fetch_add(1, std::memory_order_relaxed);
+    m_state = S_IDLE;
+}
+
+void DmmStreamParser::Reject()
+{
+    m_garbled.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool DmmStreamParser::Step(uint8_t c)
+{
+    const Transition& t = s_table[m_state][s_class.k[c]];
+
+    // Only a CR leads back to S_IDLE from inside a frame
+    if (t.next == S_IDLE && m_state != S_IDLE)
+        ++m_framesEnded;
+    m_state = t.next;
+
+    switch (t.action)
+    {
+        case A_NONE:
+            return false;
+
+        case A_BEGIN:
+            // Cheap first-byte filter, as in DmmParser::Parse()
+            if (!DmmParser::IsKnownModeCode(static_cast<char>(c)))
+                break;
+            m_sample        = DmmSample();
+            m_sample.value  = std::numeric_limits<double>::quiet_NaN();
+            m_sample.scaled = m_sample.value;
+            m_modeEnd = 0;
+            m_tokens  = 0;
+            m_sample.raw[m_sample.rawLen++] = static_cast<char>(c);
+            return false;
+
+        case A_MODE_END:
+            m_sample.mode = DmmParser::ModeOf(std::string_view(m_sample.raw, m_sample.rawLen));
+            if (m_sample.mode == DmmMode::Unknown)
+                break;
+            m_modeEnd = m_sample.rawLen;
+            [[fallthrough]];      // store the blank
+        case A_STORE:
+            if (m_sample.rawLen == DmmSample::kRawMax)
+                break;
+            m_sample.raw[m_sample.rawLen++] = static_cast<char>(c);
+            return false;
+
+        case A_TOKEN:
+            if (++m_tokens > MAX_TOKENS || m_sample.rawLen == DmmSample::kRawMax)
+                break;
+            m_sample.raw[m_sample.rawLen++] = static_cast<char>(c);
+            return false;
+
+        case A_EMIT:
+            if (m_tokens == 0)
+            {
+                Reject();           // mode word with nothing after it
+                return false;
+            }
+            m_parser.ParseValueAndUnits(m_modeEnd + 1u, m_sample.rawLen, m_sample);
+            return true;
+
+        case A_REJECT:
+            Reject();
+            return false;
+    }
+
+    // An action above refused the byte: the frame is garbled.
+    Reject();
+    m_state = S_SKIP;
+    return false;
+}
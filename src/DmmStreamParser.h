@@ -0,0 +1,76 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — DmmStreamParser.h
+//  Incremental, byte-at-a-time parser for the meter's output.
+//
+//  Bytes are fed straight from the serial receive ring; there
+//  is no separate line buffer.  A table-driven state machine
+//  copies each byte into the DmmSample under construction,
+//  checks the mode word as soon as it ends, and emits the
+//  sample on the CR, so a reading is ready the moment its
+//  terminator arrives.
+//
+//  Anything that cannot be a reading (unknown mode word,
+//  control bytes, a line longer than DmmSample::kRawMax, too
+//  many tokens) switches the machine to a skip state that
+//  waits for the next CR and is counted in Garbled().  One
+//  dropped CR therefore costs at most two lines.
+//
+//  Not thread-safe: one parser per port, used by the thread
+//  that reads that port.  Garbled() may be read from anywhere.
+// ============================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "DmmParser.h"
+
+class DmmStreamParser
+{
+public:
+    DmmStreamParser();
+
+    // Run 'len' bytes through the machine, calling onSample(DmmSample&)
+    // for each complete reading.  The sample's timestamps are zero;
+    // the callback fills them in.  All bytes are consumed.
+    template <typename Fn>
+    void Feed(const uint8_t* data, size_t len, Fn&& onSample)
+    {
+        for (size_t i = 0; i < len; ++i)
+            if (Step(data[i]))
+            {
+                m_crOffset = i;
+                onSample(m_sample);
+            }
+    }
+
+    // Inside onSample: offset of the CR within the bytes being fed.
+    size_t CrOffset() const { return m_crOffset; }
+
+    // Drop a partially received frame (e.g. after a reply timeout).
+    // A frame that had started counts as garbled.
+    void Reset();
+
+    // True while a frame has started but its CR has not arrived.
+    bool InFrame() const { return m_state != 0; }
+
+    // Frames finished by their CR, emitted or rejected (parser thread).
+    // A change means the reply in progress is over, whatever it held.
+    uint64_t FramesEnded() const { return m_framesEnded; }
+
+    // Frames discarded since construction (thread-safe read).
+    uint64_t Garbled() const { return m_garbled.load(std::memory_order_relaxed); }
+
+private:
+    // Advance by one byte; true when m_sample holds a new reading.
+    bool Step(uint8_t c);
+    void Reject();
+
+    DmmParser             m_parser;
+    DmmSample             m_sample;
+    uint8_t               m_state   = 0;     // see the state table in the .cpp
+    uint8_t               m_modeEnd = 0;     // offset of the space after the mode word
+    uint8_t               m_tokens  = 0;     // tokens after the mode word
+    size_t                m_crOffset = 0;    // see CrOffset()
+    uint64_t              m_framesEnded = 0; // see FramesEnded()
+    std::atomic<uint64_t> m_garbled;
+};
@@ -2,5 +2,16 @@
 
 #include <wx/event.h>
 
+// v1.6.0: EVT_DMM_READING is a wakeup only.  The readings themselves
+// travel through the ReadingQueue shared by ReaderThread and MainFrame;
+// one event is posted when the queue goes from idle to non-empty.
 wxDECLARE_EVENT(EVT_DMM_READING, wxCommandEvent);
-wxDECLARE_EVENT(EVT_DMM_ERROR,   wxCommandEvent);
\ No newline at end of file
+wxDECLARE_EVENT(EVT_DMM_ERROR,   wxCommandEvent);
+
+// Posted when a raw-capture replay has reached the end of the file.
+// GetInt() is 1 if the capture ended in a partial block.
+wxDECLARE_EVENT(EVT_DMM_DONE,    wxCommandEvent);
+
+// v1.6.0: posted by MainFrame's AsyncLogWriter error handler (from the
+// writer thread) when the CSV file can no longer be written.
+wxDECLARE_EVENT(EVT_LOG_ERROR,   wxCommandEvent);
@@ -0,0 +1,97 @@
+// ============================================================
+//  Protek506Logger — HistogramPanel.cpp
+// ============================================================
+#include "HistogramPanel.h"
+#include <wx/dcbuffer.h>
+#include <wx/settings.h>
+#include <algorithm>
+
+HistogramPanel::HistogramPanel(wxWindow* parent, wxWindowID id)
+    : wxPanel(parent, id, wxDefaultPosition, wxSize(200, -1),
+              wxFULL_REPAINT_ON_RESIZE)
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);     // needed for wxAutoBufferedPaintDC
+    SetMinSize(wxSize(160, 100));
+
+    Bind(wxEVT_PAINT, &HistogramPanel::OnPaint, this);
+}
+
+void HistogramPanel::Clear()
+{
+    m_data = HistogramSnapshot();
+    Refresh(false);
+}
+
+void HistogramPanel::SetData(const HistogramSnapshot& h, DmmUnit unit)
+{
+    // A snapshot with the same total, grid and unit draws the same bars.
+    if (h.total == m_data.total && h.width == m_data.width &&
+        h.base == m_data.base && unit == m_unit)
+        return;
+    m_data = h;
+    m_unit = unit;
+    Refresh(false);
+}
+
+void HistogramPanel::OnPaint(wxPaintEvent&)
+{
+    wxAutoBufferedPaintDC dc(this);
+    wxColour bg   = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW);
+    wxColour grey = wxSystemSettings::GetColour(wxSYS_COLOUR_GRAYTEXT);
+    dc.SetBackground(wxBrush(bg));
+    dc.Clear();
+    dc.SetFont(GetFont());
+    dc.SetTextForeground(grey);
+
+    const int textH = dc.GetCharHeight();
+    wxSize    sz    = GetClientSize();
+    wxRect    r(2, 2, sz.GetWidth() - 4, sz.GetHeight() - textH - 6);
+    dc.SetPen(wxPen(grey));
+    dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    dc.DrawRectangle(r);
+    if (r.GetWidth() < 8 || r.GetHeight() < 8) return;
+
+    // Occupied bins and the tallest one
+    int      first = HistogramSnapshot::kBins, last = -1;
+    uint64_t peak  = 0;
+    for (int i = 0; i < HistogramSnapshot::kBins; ++i)
+    {
+        uint64_t n = m_data.counts[static_cast<size_t>(i)];
+        if (n == 0) continue;
+        first = std::min(first, i);
+        last  = i;
+        peak  = std::max(peak, n);
+    }
+    if (last < 0)
+    {
+        dc.DrawText("No data", r.GetLeft() + 4, r.GetTop() + 4);
+        return;
+    }
+
+    // Bars edge to edge; a one-pixel gap once they are wide enough
+    const int    nBins = last - first + 1;
+    const int    plotW = r.GetWidth() - 2;
+    const int    plotH = r.GetHeight() - 2;
+    const double binPx = static_cast<double>(plotW) / nBins;
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(wxBrush(wxColour(60, 60, 180)));
+    for (int i = first; i <= last; ++i)
+    {
+        uint64_t n = m_data.counts[static_cast<size_t>(i)];
+        if (n == 0) continue;
+        int x0 = r.GetLeft() + 1 + static_cast<int>((i - first) * binPx);
+        int x1 = r.GetLeft() + 1 + static_cast<int>((i - first + 1) * binPx);
+        if (binPx >= 4) --x1;
+        int h  = std::max(1, static_cast<int>(static_cast<double>(n) * plotH / peak));
+        dc.DrawRectangle(x0, r.GetBottom() - h, std::max(1, x1 - x0), h);
+    }
+
+    // Range under the plot, in the range the meter is on now
+    const double scale = DmmUnitScale(m_unit);
+    const int    y     = r.GetBottom() + 3;
+    wxString lo = wxString::Format("%.6g", m_data.BinLow(first) / scale);
+    wxString hi = wxString::Format("%.6g %s", m_data.BinLow(last + 1) / scale,
+                                   DmmUnitText(m_unit));
+    dc.DrawText(lo, r.GetLeft(), y);
+    dc.DrawText(hi, r.GetRight() - dc.GetTextExtent(hi).GetWidth(), y);
+}
@@ -0,0 +1,29 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — HistogramPanel.h
+//  Custom-drawn bar chart of a HistogramSnapshot, shown next
+//  to the stats rows while a stats run has data.
+//
+//  Only the occupied bins are drawn, so the bars fill the
+//  panel whatever the histogram's current bin width; the x
+//  labels are the range in the unit the meter is on now.
+//  SetData() repaints only when the counts or the unit change.
+// ============================================================
+#include <wx/wx.h>
+#include "DmmParser.h"
+#include "StreamHistogram.h"
+
+class HistogramPanel : public wxPanel
+{
+public:
+    explicit HistogramPanel(wxWindow* parent, wxWindowID id = wxID_ANY);
+
+    void SetData(const HistogramSnapshot& h, DmmUnit unit);
+    void Clear();
+
+private:
+    void OnPaint(wxPaintEvent& evt);
+
+    HistogramSnapshot m_data;
+    DmmUnit           m_unit = DmmUnit::None;
+};
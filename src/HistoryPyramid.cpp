@@ -0,0 +1,138 @@
+// ============================================================
+//  Protek506Logger — HistoryPyramid.cpp
+// ============================================================
+#include "HistoryPyramid.h"
+#include <cmath>
+
+const int64_t HistoryPyramid::kLevelUs[kLevels] = {
+    1000000LL, 10000000LL, 60000000LL, 600000000LL
+};
+
+// 1 day of 1 s, 7 days of 10 s, 30 days of 1 min, a year of 10 min
+const size_t HistoryPyramid::kDefaultLevelCapacity[kLevels] = {
+    86400, 60480, 43200, 52560
+};
+
+HistoryPyramid::HistoryPyramid()
+{
+    m_raw.Reset(kDefaultRawCapacity);
+    for (int l = 0; l < kLevels; ++l)
+        m_levels[l].Reset(kDefaultLevelCapacity[l]);
+}
+
+void HistoryPyramid::SetRawCapacity(size_t capacity)
+{
+    m_raw.Reset(capacity);
+    Clear();
+}
+
+void HistoryPyramid::Clear()
+{
+    m_raw.Reset(m_raw.Capacity());
+    for (int l = 0; l < kLevels; ++l)
+        m_levels[l].Reset(m_levels[l].Capacity());
+}
+
+// Each level either extends its newest bucket or opens the next one;
+// no level is ever derived from another, so there is nothing to redo.
+void HistoryPyramid::Append(int64_t monoUs, double value)
+{
+    HistoryPoint p = { monoUs, value };
+    m_raw.Push(p);
+
+    const bool numeric = !std::isnan(value);
+    for (int l = 0; l < kLevels; ++l)
+    {
+        HistoryRing<HistoryBucket>& ring = m_levels[l];
+        const int64_t start = monoUs - monoUs % kLevelUs[l];
+        if (ring.Empty() || ring.Back().startUs != start)
+        {
+            HistoryBucket b;
+            b.startUs = start;
+            ring.Push(b);
+        }
+        HistoryBucket& b = ring.Back();
+        if (!numeric)
+        {
+            ++b.other;
+            continue;
+        }
+        if (b.count == 0)
+        {
+            b.minValue = b.maxValue = value;
+        }
+        else
+        {
+            if (value < b.minValue) b.minValue = value;
+            if (value > b.maxValue) b.maxValue = value;
+        }
+        b.sum += value;
+        ++b.count;
+    }
+}
+
+// A level covers t0 if it has never dropped anything, or its oldest
+// entry is no later than t0.
+bool HistoryPyramid::Covers(int level, int64_t t0) const
+{
+    if (level == kRaw)
+        return !m_raw.Wrapped() || (!m_raw.Empty() && m_raw[0].monoUs <= t0);
+    const HistoryRing<HistoryBucket>& ring = m_levels[level];
+    return !ring.Wrapped() || (!ring.Empty() && ring[0].startUs <= t0);
+}
+
+int HistoryPyramid::PickLevel(int64_t t0, int64_t t1, size_t maxItems) const
+{
+    if (Covers(kRaw, t0))
+    {
+        size_t i = m_raw.LowerBound(t0, [](const HistoryPoint& p) { return p.monoUs; });
+        size_t j = m_raw.LowerBound(t1 + 1, [](const HistoryPoint& p) { return p.monoUs; });
+        if (j - i <= maxItems)
+            return kRaw;
+    }
+    for (int l = 0; l < kLevels; ++l)
+    {
+        // Upper bound on the buckets in range; empty seconds have none.
+        size_t buckets = static_cast<size_t>((t1 - t0) / kLevelUs[l]) + 2;
+        if (buckets <= maxItems && Covers(l, t0))
+            return l;
+    }
+    return kLevels - 1;
+}
+
+bool HistoryPyramid::Summary(int64_t t0, int64_t t1, HistoryBucket& out,
+                             size_t maxItems) const
+{
+    out = HistoryBucket();
+    out.startUs = t0;
+
+    auto merge = [&out](double mn, double mx, double sum, uint32_t n, uint32_t other) {
+        out.other += other;
+        if (n == 0) return;
+        if (out.count == 0) { out.minValue = mn; out.maxValue = mx; }
+        else
+        {
+            if (mn < out.minValue) out.minValue = mn;
+            if (mx > out.maxValue) out.maxValue = mx;
+        }
+        out.sum   += sum;
+        out.count += n;
+    };
+
+    int level = PickLevel(t0, t1, maxItems);
+    if (level == kRaw)
+    {
+        ForEachRaw(t0, t1, [&merge](const HistoryPoint& p) {
+            if (std::isnan(p.value)) merge(0, 0, 0, 0, 1);
+            else                     merge(p.value, p.value, p.value, 1, 0);
+        });
+    }
+    else
+    {
+        // Edge buckets may reach a little outside [t0, t1].
+        ForEachBucket(level, t0, t1, [&merge](const HistoryBucket& b) {
+            merge(b.minValue, b.maxValue, b.sum, b.count, b.other);
+        });
+    }
+    return out.count > 0;
+}
@@ -0,0 +1,156 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — HistoryPyramid.h
+//  Multi-resolution history of one numeric series.
+//
+//  Keeps a rolling window of full-rate samples plus four
+//  coarser levels with 1 s, 10 s, 1 min and 10 min buckets.
+//  Each bucket holds min / max / sum / count of the numeric
+//  samples in it (and a count of non-numeric ones: OL, ...),
+//  and every level is updated as each sample arrives, so there
+//  is nothing to rebuild.  Each level is a fixed-size ring; by
+//  default the raw window holds an hour at 5 Hz and the levels
+//  reach back 1 day, 7 days, 30 days and a year.
+//
+//  A query over a long range picks the finest level that still
+//  covers the range in at most N items, so "last 24 h" touches
+//  1440 one-minute buckets instead of 400 000 readings.
+//
+//  Not thread-safe; fed and read on the GUI thread.
+// ============================================================
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct HistoryPoint
+{
+    int64_t monoUs;
+    double  value;              // NaN = not a number (OL, OPEN, ...)
+};
+
+struct HistoryBucket
+{
+    int64_t  startUs  = 0;      // bucket start, a multiple of the level width
+    double   minValue = 0.0;
+    double   maxValue = 0.0;
+    double   sum      = 0.0;
+    uint32_t count    = 0;      // numeric samples
+    uint32_t other    = 0;      // non-numeric samples
+
+    double Mean() const { return count ? sum / count : 0.0; }
+};
+
+// Fixed-capacity ring, oldest element at index 0.
+template <typename T>
+class HistoryRing
+{
+public:
+    void Reset(size_t capacity)
+    {
+        std::vector<T>().swap(m_items);
+        m_capacity = capacity > 0 ? capacity : 1;
+        m_head     = 0;
+        m_wrapped  = false;
+    }
+
+    void Push(const T& item)
+    {
+        if (m_items.size() < m_capacity)
+        {
+            m_items.push_back(item);
+            return;
+        }
+        m_items[m_head] = item;
+        m_head    = (m_head + 1) % m_capacity;
+        m_wrapped = true;
+    }
+
+    size_t   Size()     const { return m_items.size(); }
+    bool     Empty()    const { return m_items.empty(); }
+    bool     Wrapped()  const { return m_wrapped; }   // has dropped anything
+    size_t   Capacity() const { return m_capacity; }
+    const T& operator[](size_t i) const { return m_items[Index(i)]; }
+    T&       Back()           { return m_items[Index(m_items.size() - 1)]; }
+    const T& Back()     const { return m_items[Index(m_items.size() - 1)]; }
+
+    // First index whose key(item) >= key
+    template <typename Key>
+    size_t LowerBound(int64_t t, Key key) const
+    {
+        size_t lo = 0, hi = m_items.size();
+        while (lo < hi)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (key((*this)[mid]) < t) lo = mid + 1;
+            else                       hi = mid;
+        }
+        return lo;
+    }
+
+private:
+    size_t Index(size_t i) const
+    {
+        size_t j = m_head + i;
+        return j < m_items.size() ? j : j - m_items.size();
+    }
+
+    std::vector<T> m_items;
+    size_t         m_capacity = 1;
+    size_t         m_head     = 0;
+    bool           m_wrapped  = false;
+};
+
+class HistoryPyramid
+{
+public:
+    static constexpr int    kLevels = 4;
+    static const int64_t    kLevelUs[kLevels];             // 1 s, 10 s, 1 min, 10 min
+    static const size_t     kDefaultLevelCapacity[kLevels];
+    static constexpr size_t kDefaultRawCapacity = 18000;   // 1 h at 5 Hz
+    static constexpr int    kRaw = -1;                     // level id of the raw window
+
+    HistoryPyramid();
+
+    void SetRawCapacity(size_t capacity);            // clears
+    size_t RawCapacity() const { return m_raw.Capacity(); }
+
+    void Clear();
+    void Append(int64_t monoUs, double value);       // NaN for non-numeric
+
+    bool    Empty()  const { return m_raw.Empty(); }
+    int64_t LastUs() const { return m_raw.Empty() ? 0 : m_raw.Back().monoUs; }
+
+    // Finest level (kRaw, 0 .. kLevels-1) that still holds all of
+    // [t0, t1] and needs at most maxItems items for it; the coarsest
+    // level if none does.
+    int PickLevel(int64_t t0, int64_t t1, size_t maxItems) const;
+
+    // Visit the raw points / a level's buckets that overlap [t0, t1].
+    template <typename Fn> void ForEachRaw(int64_t t0, int64_t t1, Fn fn) const
+    {
+        size_t i = m_raw.LowerBound(t0, [](const HistoryPoint& p) { return p.monoUs; });
+        for (; i < m_raw.Size() && m_raw[i].monoUs <= t1; ++i)
+            fn(m_raw[i]);
+    }
+    template <typename Fn> void ForEachBucket(int level, int64_t t0, int64_t t1, Fn fn) const
+    {
+        const HistoryRing<HistoryBucket>& ring = m_levels[level];
+        const int64_t width = kLevelUs[level];
+        size_t i = ring.LowerBound(t0 - width + 1,
+                                   [](const HistoryBucket& b) { return b.startUs; });
+        for (; i < ring.Size() && ring[i].startUs <= t1; ++i)
+            fn(ring[i]);
+    }
+
+    // min / max / mean / count over [t0, t1], from whichever level
+    // covers it in at most maxItems buckets.  False if nothing numeric.
+    bool Summary(int64_t t0, int64_t t1, HistoryBucket& out,
+                 size_t maxItems = 4096) const;
+
+private:
+    bool Covers(int level, int64_t t0) const;
+
+    HistoryRing<HistoryPoint>  m_raw;
+    HistoryRing<HistoryBucket> m_levels[kLevels];
+};
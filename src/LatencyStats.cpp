@@ -0,0 +1,197 @@
+// ============================================================
+//  Protek506Logger — LatencyStats.cpp
+// ============================================================
+#include "LatencyStats.h"
+#include <chrono>
+#include <cstdio>
+
+static const char* const STAGE_NAMES[] =
+{
+    "reply", "receive", "fanout", "queue", "render", "display", "logwrite", "logflush"
+};
+
+static const char* const STAGE_TEXT[] =
+{
+    "Trigger written to first reply byte",
+    "First reply byte to CR (reading parsed)",
+    "CR to queued for the GUI (alarms, log, history, stats)",
+    "Queued to taken by the GUI frame tick",
+    "Taken by the GUI to display updated",
+    "CR to display updated",
+    "CR to row written by the log writer",
+    "CR to row flushed to the log file",
+};
+
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == LatencyStats::kStages,
+              "one name per latency stage");
+static_assert(sizeof(STAGE_TEXT) / sizeof(STAGE_TEXT[0]) == LatencyStats::kStages,
+              "one description per latency stage");
+
+const char* LatencyStageName(LatencyStage stage)
+{
+    int i = static_cast<int>(stage);
+    return i >= 0 && i < LatencyStats::kStages ? STAGE_NAMES[i] : "";
+}
+
+const char* LatencyStageText(LatencyStage stage)
+{
+    int i = static_cast<int>(stage);
+    return i >= 0 && i < LatencyStats::kStages ? STAGE_TEXT[i] : "";
+}
+
+// ----------------------------------------------------------------
+// Buckets: 0..3 µs one each, then four per power of two
+// ----------------------------------------------------------------
+int LatencyHistogram::Bucket(int64_t us)
+{
+    if (us < kSubBuckets) return us < 0 ? 0 : static_cast<int>(us);
+
+    // floor(log2(us)) by halving the search range; no intrinsics needed
+    uint64_t v = static_cast<uint64_t>(us);
+    int e = 0;
+    for (int step = 32; step > 0; step /= 2)
+        if (v >> (e + step)) e += step;
+
+    int i = kSubBuckets * (e - 1) + static_cast<int>((v >> (e - 2)) & (kSubBuckets - 1));
+    return i < kBuckets ? i : kBuckets - 1;
+}
+
+int64_t LatencyHistogram::BucketLow(int i)
+{
+    if (i < kSubBuckets) return i;
+    int e   = i / kSubBuckets + 1;
+    int sub = i % kSubBuckets;
+    return static_cast<int64_t>(kSubBuckets + sub) << (e - 2);
+}
+
+int64_t LatencyHistogram::PercentileUs(double p) const
+{
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count));
+    if (rank >= count) rank = count - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        seen += counts[static_cast<size_t>(i)];
+        if (seen > rank)
+        {
+            int64_t high = i + 1 < kBuckets ? BucketLow(i + 1) - 1 : maxUs;
+            return high < maxUs ? high : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+// ----------------------------------------------------------------
+// Recording
+// ----------------------------------------------------------------
+LatencyStats::LatencyStats()
+{
+    for (Stage& st : m_stages)
+        for (auto& c : st.counts)
+            c.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyStats::NowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyStats::Record(LatencyStage stage, int64_t us)
+{
+    int idx = static_cast<int>(stage);
+    if (idx < 0 || idx >= kStages) return;
+    Stage& st = m_stages[static_cast<size_t>(idx)];
+
+    // Single writer per stage: plain load / store instead of RMW.
+    uint32_t gen = m_resetGen.load(std::memory_order_relaxed);
+    if (gen != st.gen.load(std::memory_order_relaxed))
+    {
+        for (auto& c : st.counts)
+            c.store(0, std::memory_order_relaxed);
+        st.count.store(0, std::memory_order_relaxed);
+        st.sumUs.store(0, std::memory_order_relaxed);
+        st.maxUs.store(0, std::memory_order_relaxed);
+        st.gen.store(gen, std::memory_order_relaxed);
+    }
+
+    auto& bucket = st.counts[static_cast<size_t>(LatencyHistogram::Bucket(us))];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    st.count.store(st.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    st.sumUs.store(st.sumUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    if (us > st.maxUs.load(std::memory_order_relaxed))
+        st.maxUs.store(us, std::memory_order_relaxed);
+}
+
+LatencyHistogram LatencyStats::Snapshot(LatencyStage stage) const
+{
+    LatencyHistogram h;
+    int idx = static_cast<int>(stage);
+    if (idx < 0 || idx >= kStages) return h;
+    const Stage& st = m_stages[static_cast<size_t>(idx)];
+
+    // A reset that the recording thread has not carried out yet
+    if (st.gen.load(std::memory_order_relaxed) != m_resetGen.load(std::memory_order_relaxed))
+        return h;
+
+    for (size_t i = 0; i < h.counts.size(); ++i)
+        h.counts[i] = st.counts[i].load(std::memory_order_relaxed);
+    h.count = st.count.load(std::memory_order_relaxed);
+    h.sumUs = st.sumUs.load(std::memory_order_relaxed);
+    h.maxUs = st.maxUs.load(std::memory_order_relaxed);
+    return h;
+}
+
+// ----------------------------------------------------------------
+// JSON export
+// ----------------------------------------------------------------
+bool LatencyStats::ExportJson(const std::string& path) const
+{
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) return false;
+
+    fprintf(fp, "{\n  \"unit\": \"us\",\n  \"stages\": [\n");
+    for (int s = 0; s < kStages; ++s)
+    {
+        LatencyStage stage = static_cast<LatencyStage>(s);
+        LatencyHistogram h = Snapshot(stage);
+        fprintf(fp,
+                "    {\n"
+                "      \"name\": \"%s\",\n"
+                "      \"description\": \"%s\",\n"
+                "      \"count\": %llu,\n"
+                "      \"mean\": %.1f,\n"
+                "      \"p50\": %lld,\n"
+                "      \"p90\": %lld,\n"
+                "      \"p99\": %lld,\n"
+                "      \"p999\": %lld,\n"
+                "      \"max\": %lld,\n"
+                "      \"buckets\": [",
+                LatencyStageName(stage), LatencyStageText(stage),
+                static_cast<unsigned long long>(h.count), h.MeanUs(),
+                static_cast<long long>(h.PercentileUs(0.50)),
+                static_cast<long long>(h.PercentileUs(0.90)),
+                static_cast<long long>(h.PercentileUs(0.99)),
+                static_cast<long long>(h.PercentileUs(0.999)),
+                static_cast<long long>(h.maxUs));
+
+        // Non-empty buckets only, as [low, count]
+        const char* sep = "";
+        for (int i = 0; i < LatencyHistogram::kBuckets; ++i)
+        {
+            uint64_t n = h.counts[static_cast<size_t>(i)];
+            if (n == 0) continue;
+            fprintf(fp, "%s[%lld, %llu]", sep,
+                    static_cast<long long>(LatencyHistogram::BucketLow(i)),
+                    static_cast<unsigned long long>(n));
+            sep = ", ";
+        }
+        fprintf(fp, "]\n    }%s\n", s + 1 < kStages ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+
+    bool ok = !ferror(fp);
+    return fclose(fp) == 0 && ok;
+}
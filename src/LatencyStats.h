@@ -0,0 +1,103 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — LatencyStats.h
+//  Per-stage latency histograms for the path from the meter
+//  to the screen and the log file.
+//
+//  Each stage is the time between two steady-clock stamps on
+//  the way (trigger written, first reply byte, CR, queued for
+//  the GUI, taken by the frame tick, display updated, row
+//  written, row flushed).  Record() files it in a fixed
+//  log-linear histogram: four buckets per power of two from
+//  1 µs to about 36 minutes, so any percentile is within 25 %.
+//
+//  Record() allocates nothing and takes no lock; it is a few
+//  integer operations and relaxed atomic stores, cheap enough
+//  to stay on all the time.  Each stage must be recorded from
+//  one thread at a time (it is: every stage belongs to one of
+//  the reader, GUI or log writer threads).  Snapshots and
+//  Reset() may come from any thread; a reset is carried out by
+//  the recording thread on its next Record().
+// ============================================================
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+enum class LatencyStage : uint8_t
+{
+    Reply,          // trigger written   → first byte of the reply
+    Receive,        // first byte        → CR (reading parsed)
+    FanOut,         // CR                → queued for the GUI (alarms, log, history, stats)
+    Queue,          // queued            → taken by the GUI frame tick
+    Render,         // taken             → live display updated
+    Display,        // CR                → live display updated
+    LogWrite,       // CR                → row handed to the file by the log writer
+    LogFlush,       // CR                → row flushed to the file
+    Count
+};
+
+// Short name ("reply") and one-line description of a stage
+const char* LatencyStageName(LatencyStage stage);
+const char* LatencyStageText(LatencyStage stage);
+
+// A copy of one stage's histogram
+struct LatencyHistogram
+{
+    static const int kSubBuckets = 4;                       // per power of two
+    static const int kBuckets    = kSubBuckets * 31;        // up to 2^32 µs
+
+    std::array<uint64_t, kBuckets> counts{};
+    uint64_t count = 0;
+    int64_t  sumUs = 0;
+    int64_t  maxUs = 0;
+
+    // Bucket of a latency, and the range [BucketLow, BucketLow of the next)
+    static int     Bucket(int64_t us);
+    static int64_t BucketLow(int i);
+
+    double  MeanUs() const { return count ? static_cast<double>(sumUs) / count : 0.0; }
+
+    // Upper edge of the bucket holding the p-th fraction (0..1) of the
+    // samples, capped at the maximum seen; 0 if empty.
+    int64_t PercentileUs(double p) const;
+};
+
+class LatencyStats
+{
+public:
+    static const int kStages = static_cast<int>(LatencyStage::Count);
+
+    LatencyStats();
+
+    LatencyStats(const LatencyStats&) = delete;
+    LatencyStats& operator=(const LatencyStats&) = delete;
+
+    // Recording thread of 'stage'
+    void Record(LatencyStage stage, int64_t us);
+    void Record(LatencyStage stage, int64_t fromUs, int64_t toUs) { Record(stage, toUs - fromUs); }
+
+    // Any thread
+    LatencyHistogram Snapshot(LatencyStage stage) const;
+    void Reset() { m_resetGen.fetch_add(1, std::memory_order_relaxed); }
+
+    // Every stage as JSON: count, mean, max, percentiles and the
+    // non-empty buckets.  False if the file cannot be written.
+    bool ExportJson(const std::string& path) const;
+
+    // steady_clock µs, the clock of DmmSample::monoUs
+    static int64_t NowUs();
+
+private:
+    struct Stage
+    {
+        std::array<std::atomic<uint64_t>, LatencyHistogram::kBuckets> counts;
+        std::atomic<uint64_t> count{0};
+        std::atomic<int64_t>  sumUs{0};
+        std::atomic<int64_t>  maxUs{0};
+        std::atomic<uint32_t> gen{0};       // written by the recording thread
+    };
+
+    std::array<Stage, kStages> m_stages;
+    std::atomic<uint32_t>      m_resetGen{0};
+};
@@ -0,0 +1,152 @@
+// ============================================================
+//  Protek506Logger — LogFile.cpp
+// ============================================================
+#include "LogFile.h"
+#ifdef _WIN32
+#include <io.h>         // _commit, _fileno
+#else
+#include <unistd.h>     // fdatasync / fsync
+#endif
+
+bool LogFile::Open(const std::string& filePath, const char* mode)
+{
+    Close();
+    m_writeOk      = true;
+    m_rowCount     = 0;
+    m_unflushed    = false;
+    m_pendingRows  = 0;
+    m_syncPending  = false;
+    m_bytesWritten = 0;
+    m_flushCount   = 0;
+    m_worstFlushUs = 0;
+
+    m_fp = fopen(filePath.c_str(), mode);
+    if (!m_fp)
+    {
+        m_lastError = "Cannot open file: " + filePath;
+        m_writeOk   = false;
+        return false;
+    }
+    m_buffer.resize(kBufferSize);
+    setvbuf(m_fp, m_buffer.data(), _IOFBF, m_buffer.size());
+    m_lastSync = Clock::now();
+    return true;
+}
+
+void LogFile::Close()
+{
+    if (!m_fp) return;
+    Flush();
+    if (m_fp && m_syncPending && m_policy.syncMs > 0)
+        Sync();
+    if (m_fp)
+    {
+        fclose(m_fp);
+        m_fp = nullptr;
+    }
+}
+
+bool LogFile::Write(const void* data, size_t len)
+{
+    if (!m_fp) return false;
+
+    // fix #12: Detect write failure (e.g. disk full).  Close the file so
+    // IsOpen() returns false, letting the caller know logging has stopped.
+    if (fwrite(data, 1, len, m_fp) != len)
+    {
+        Fail("Write error (disk full or I/O error)");
+        return false;
+    }
+    m_bytesWritten += len;
+    m_unflushed     = true;
+    return true;
+}
+
+void LogFile::RowWritten()
+{
+    if (!m_fp) return;
+    ++m_rowCount;
+
+    if (m_pendingRows++ == 0)
+        m_oldestPending = Clock::now();
+
+    if (m_policy.everyRows > 0 && m_pendingRows >= m_policy.everyRows)
+        Flush();
+    else
+        Tick();
+}
+
+void LogFile::Tick()
+{
+    if (!m_fp) return;
+
+    if (m_pendingRows > 0 && m_policy.everyMs > 0 &&
+        Clock::now() - m_oldestPending >= std::chrono::milliseconds(m_policy.everyMs))
+        Flush();
+
+    if (m_fp && m_syncPending && m_policy.syncMs > 0 &&
+        Clock::now() - m_lastSync >= std::chrono::milliseconds(m_policy.syncMs))
+        Sync();
+}
+
+bool LogFile::Flush()
+{
+    if (!m_fp) return m_writeOk;
+    if (!m_unflushed) return true;
+
+    Clock::time_point start = Clock::now();
+    int rc = fflush(m_fp);
+    NoteLatency(start);
+    ++m_flushCount;
+    m_unflushed   = false;
+    m_pendingRows = 0;
+    m_syncPending = true;
+
+    if (rc != 0 || ferror(m_fp))
+    {
+        Fail("Write error (disk full or I/O error)");
+        return false;
+    }
+    return true;
+}
+
+bool LogFile::Sync()
+{
+    Clock::time_point start = Clock::now();
+#if defined(_WIN32)
+    int rc = _commit(_fileno(m_fp));
+#elif defined(__linux__)
+    int rc = fdatasync(fileno(m_fp));
+#else
+    int rc = fsync(fileno(m_fp));       // no fdatasync on macOS
+#endif
+    NoteLatency(start);
+    m_lastSync    = Clock::now();
+    m_syncPending = false;
+
+    if (rc != 0)
+    {
+        Fail("Sync error (disk full or I/O error)");
+        return false;
+    }
+    return true;
+}
+
+void LogFile::Fail(const std::string& msg)
+{
+    m_lastError = msg;
+    m_writeOk   = false;
+    if (m_fp)
+    {
+        fclose(m_fp);
+        m_fp = nullptr;
+    }
+}
+
+void LogFile::NoteLatency(Clock::time_point start)
+{
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                     Clock::now() - start).count();
+    if (us > m_worstFlushUs)
+        m_worstFlushUs = us;
+}
@@ -0,0 +1,88 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — LogFile.h
+//  The file under a session log: a 64 KiB stdio buffer, the
+//  LogFlushPolicy, fdatasync on a timer, write-error handling
+//  and the flush counters.  CsvLogger and BinLogger each own
+//  one and only decide what bytes go into it.
+//
+//  A failed write, flush or sync closes the file: WriteOk()
+//  turns false and LastError() says why.  A write error is
+//  only seen when the buffer is flushed, so that may happen on
+//  Tick() or Flush() as well as on Write().
+// ============================================================
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SampleLog.h"
+
+class LogFile
+{
+public:
+    LogFile() {}
+    ~LogFile() { Close(); }
+
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    // Open for appending ("a" or "ab") and reset the counters.  False
+    // with LastError() set if the file cannot be opened.
+    bool Open(const std::string& filePath, const char* mode);
+
+    // Flush, sync if the policy asks for it, and close.
+    void Close();
+    bool IsOpen() const { return m_fp != nullptr; }
+
+    void SetFlushPolicy(const LogFlushPolicy& policy) { m_policy = policy; }
+    const LogFlushPolicy& FlushPolicy() const { return m_policy; }
+
+    // Buffer 'len' bytes.  False (and the file closed) on a write error.
+    bool Write(const void* data, size_t len);
+
+    // One row has been written: count it and apply the policy.
+    void RowWritten();
+
+    // Apply the time-based parts of the policy.  Cheap when nothing is
+    // due; call it from a timer and after each batch of rows.
+    void Tick();
+
+    // Push buffered bytes to the OS now.  Returns WriteOk().
+    bool Flush();
+
+    bool        WriteOk()   const { return m_writeOk; }
+    std::string LastError() const { return m_lastError; }
+
+    // Counters since Open()
+    long     RowCount()     const { return m_rowCount; }
+    uint64_t BytesWritten() const { return m_bytesWritten; }
+    uint64_t FlushCount()   const { return m_flushCount; }
+    int64_t  WorstFlushUs() const { return m_worstFlushUs; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    bool Sync();
+    void Fail(const std::string& msg);
+    void NoteLatency(Clock::time_point start);
+
+    FILE*             m_fp = nullptr;
+    std::vector<char> m_buffer;        // stdio buffer, lives as long as m_fp
+    std::string       m_lastError;
+    bool              m_writeOk  = true;
+    long              m_rowCount = 0;
+
+    LogFlushPolicy    m_policy;
+    bool              m_unflushed    = false; // bytes written since the last flush
+    int               m_pendingRows  = 0;     // rows written since the last flush
+    Clock::time_point m_oldestPending;        // time of the first pending row
+    Clock::time_point m_lastSync;
+    bool              m_syncPending  = false; // flushed but not yet synced
+    uint64_t          m_bytesWritten = 0;
+    uint64_t          m_flushCount   = 0;
+    int64_t           m_worstFlushUs = 0;
+};
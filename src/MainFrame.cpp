@@ -3,6 +3,7 @@
 // ============================================================
 #include "MainFrame.h"
 #include <wx/aboutdlg.h>
+#include <wx/choicdlg.h>
 #include <wx/stdpaths.h>
 #include <wx/filename.h>
 #include <wx/datetime.h>
@@ -15,10 +16,34 @@
 #include <wx/colour.h>
 #include <wx/fileconf.h>
 #include <wx/settings.h>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include "DiagnosticsDialog.h"
 #include "Events.h"
 
-static const wxString APP_VERSION = "1.5.2";
+static const wxString APP_VERSION = "1.6.0";
 static const int      TIMER_MS    = 1000;
+static const int      DEFAULT_FPS = 30;     // live display redraw cap
+
+// ----------------------------------------------------------------
+// v1.6.0: change a label only if its text differs.  Returns true if
+// that changed the label's best size, i.e. the sizers need Layout().
+// ----------------------------------------------------------------
+static bool SetLabelIfChanged(wxStaticText* lbl, const wxString& text)
+{
+    if (lbl->GetLabel() == text) return false;
+    wxSize before = lbl->GetBestSize();
+    lbl->SetLabel(text);
+    return lbl->GetBestSize() != before;
+}
+
+static void SetColourIfChanged(wxWindow* w, const wxColour& col)
+{
+    if (w->GetForegroundColour() == col) return;
+    w->SetForegroundColour(col);
+    w->Refresh();
+}
 
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_BUTTON(ID_CONNECT,       MainFrame::OnConnect)
@@ -28,24 +53,42 @@ wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_BUTTON(ID_CLEAR_LOG,     MainFrame::OnClearLog)
     EVT_BUTTON(ID_REFRESH_PORTS, MainFrame::OnRefreshPorts)
     EVT_BUTTON(ID_TOGGLE_STATS,  MainFrame::OnToggleStats)
+    EVT_MENU(ID_SAVE_HISTORY,    MainFrame::OnSaveHistory)
+    EVT_MENU(ID_EXPORT_STATS,    MainFrame::OnExportStats)
+    EVT_MENU(ID_EXPORT_HISTOGRAM, MainFrame::OnExportHistogram)
+    EVT_MENU(ID_RECORD_RAW,      MainFrame::OnRecordRaw)
+    EVT_MENU(ID_REPLAY_RAW,      MainFrame::OnReplayRaw)
+    EVT_MENU(ID_DIAGNOSTICS,     MainFrame::OnDiagnostics)
     EVT_MENU(wxID_EXIT,          MainFrame::OnExit)
     EVT_MENU(wxID_ABOUT,         MainFrame::OnAbout)
     EVT_CLOSE(                   MainFrame::OnClose)
     EVT_TIMER(ID_TIMER,          MainFrame::OnTimer)
+    EVT_TIMER(ID_FRAME_TIMER,    MainFrame::OnFrameTimer)
     EVT_COMMAND(wxID_ANY, EVT_DMM_READING, MainFrame::OnDmmReading)
     EVT_COMMAND(wxID_ANY, EVT_DMM_ERROR,   MainFrame::OnDmmError)
+    EVT_COMMAND(wxID_ANY, EVT_DMM_DONE,    MainFrame::OnDmmDone)
+    EVT_COMMAND(wxID_ANY, EVT_LOG_ERROR,   MainFrame::OnLogError)
 wxEND_EVENT_TABLE()
 
 // ============================================================
 // Constructor / Destructor
 // ============================================================
 MainFrame::MainFrame(const wxString& title)
-    : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(820, 640))
+    : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(820, 820))
     , m_timer(this, ID_TIMER)
+    , m_frameTimer(this, ID_FRAME_TIMER)
 {
+    // Writer-thread errors come back as EVT_LOG_ERROR
+    m_logWriter.SetErrorHandler([this](const std::string& msg) {
+        auto* evt = new wxCommandEvent(EVT_LOG_ERROR);
+        evt->SetString(wxString::FromUTF8(msg.c_str()));
+        wxQueueEvent(this, evt);
+    });
+    m_logWriter.SetLatencyStats(&m_latency);
+
     BuildMenuBar();
     BuildUI();
-    SetMinSize(wxSize(700, 560));
+    SetMinSize(wxSize(700, 700));
     Centre();
     m_timer.Start(TIMER_MS);
     UpdatePortList();
@@ -56,7 +99,7 @@ MainFrame::MainFrame(const wxString& title)
 MainFrame::~MainFrame()
 {
     StopReaderThread();
-    m_logger.Close();
+    m_logWriter.Close();
 }
 
 // ============================================================
@@ -122,11 +165,13 @@ void MainFrame::BuildUI()
         wxStaticBoxSizer* sizer = new wxStaticBoxSizer(box, wxHORIZONTAL);
 
         // --- Left column: stats sub-sizer (hidden until stat-eligible mode) ---
-        m_statsSizer = new wxBoxSizer(wxVERTICAL);
+        // v1.6.0: the rows, with the run's histogram to their right.
+        m_statsSizer = new wxBoxSizer(wxHORIZONTAL);
+        wxBoxSizer* statsCol = new wxBoxSizer(wxVERTICAL);
 
         m_btnStats = new wxButton(box, ID_TOGGLE_STATS, "Start",
                                   wxDefaultPosition, wxSize(60, -1));
-        m_statsSizer->Add(m_btnStats, 0, wxALIGN_CENTER_HORIZONTAL | wxBOTTOM, 6);
+        statsCol->Add(m_btnStats, 0, wxALIGN_CENTER_HORIZONTAL | wxBOTTOM, 6);
 
         {
             wxFont lf(14, wxFONTFAMILY_DEFAULT,
@@ -146,14 +191,21 @@ void MainFrame::BuildUI()
                 valOut->SetFont(vf);
                 row->Add(l,      0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
                 row->Add(valOut, 0, wxALIGN_CENTER_VERTICAL);
-                m_statsSizer->Add(row, 0, wxEXPAND | wxBOTTOM, 3);
+                statsCol->Add(row, 0, wxEXPAND | wxBOTTOM, 3);
             };
 
             addRow("Maximum", m_lblMaxVal);
             addRow("Average", m_lblAvgVal);
             addRow("Minimum", m_lblMinVal);
+            addRow("Std Dev", m_lblSdVal);
+            addRow("Median",  m_lblMedVal);
         }
 
+        m_histogram = new HistogramPanel(box);
+        m_histogram->SetToolTip("Distribution of the readings in this run");
+        m_statsSizer->Add(statsCol,    0, wxALIGN_TOP);
+        m_statsSizer->Add(m_histogram, 0, wxEXPAND | wxLEFT, 8);
+
         // m_readingRow points to the direct parent of m_statsSizer for show/hide
         m_readingRow = sizer;
         sizer->Add(m_statsSizer, 0, wxALIGN_TOP | wxLEFT | wxTOP, 8);
@@ -187,6 +239,19 @@ void MainFrame::BuildUI()
         rootSizer->Add(sizer, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 8);
     }
 
+    // ----------------------------------------------------------
+    // v1.6.0: Trend chart (see StripChart.h)
+    // ----------------------------------------------------------
+    {
+        wxStaticBox*      box   = new wxStaticBox(root, wxID_ANY, "Trend");
+        wxStaticBoxSizer* sizer = new wxStaticBoxSizer(box, wxVERTICAL);
+
+        m_chart = new StripChart(box);
+        sizer->Add(m_chart, 1, wxEXPAND | wxALL, 2);
+
+        rootSizer->Add(sizer, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 8);
+    }
+
     // ----------------------------------------------------------
     // CSV Logging controls
     // ----------------------------------------------------------
@@ -234,19 +299,9 @@ void MainFrame::BuildUI()
                                           wxDefaultPosition, wxDefaultSize,
                                           wxBORDER_SUNKEN);
 
-        // wxListCtrl directly inside the plain panel — safe on GTK3
-        m_listLog = new wxListCtrl(tablePanel, wxID_ANY,
-                                   wxDefaultPosition, wxDefaultSize,
-                                   wxLC_REPORT | wxLC_HRULES | wxLC_VRULES |
-                                   wxBORDER_NONE);
-
-        m_listLog->InsertColumn(0, "#",       wxLIST_FORMAT_RIGHT,  50);
-        m_listLog->InsertColumn(1, "Date",    wxLIST_FORMAT_LEFT,  100);
-        m_listLog->InsertColumn(2, "Time",    wxLIST_FORMAT_LEFT,  115);
-        m_listLog->InsertColumn(3, "Mode",    wxLIST_FORMAT_LEFT,   70);
-        m_listLog->InsertColumn(4, "Reading", wxLIST_FORMAT_RIGHT, 110);
-        m_listLog->InsertColumn(5, "Units",   wxLIST_FORMAT_LEFT,   90);
-        m_listLog->InsertColumn(6, "Raw",     wxLIST_FORMAT_LEFT,  160);
+        // wxListCtrl directly inside the plain panel — safe on GTK3.
+        // v1.6.0: virtual list over a ring of rows (see ReadingTable.h).
+        m_listLog = new ReadingTable(tablePanel, wxID_ANY);
 
         wxBoxSizer* ps = new wxBoxSizer(wxVERTICAL);
         ps->Add(m_listLog, 1, wxEXPAND | wxALL, 2);
@@ -304,22 +359,36 @@ void MainFrame::OnConnect(wxCommandEvent&)
 
     if (m_thread) StopReaderThread();
 
-    m_thread = new ReaderThread(this, device.ToStdString(), pollMs);
+    // Alarms raised on the previous connection do not carry over.
+    m_alarms.Reset();
+    m_alarmsActive = 0;
+
+    m_thread = new ReaderThread(this, &m_readingQueue, &m_logWriter, &m_history,
+                                &m_stats, &m_alarms, device.ToStdString(), pollMs);
+    if (!m_rawCapturePath.IsEmpty())
+        m_thread->RecordRaw(m_rawCapturePath.ToStdString());
+    m_thread->SetLatencyStats(&m_latency);
+    if (!StartReaderThread()) return;
+    SetConnected(true);
+    m_statusBar->SetStatusText("Connecting to " + device + "...", 1);
+}
+
+bool MainFrame::StartReaderThread()
+{
     if (m_thread->Create() != wxTHREAD_NO_ERROR)
     {
         wxMessageBox("Cannot create reader thread.",
                      "Thread Error", wxOK | wxICON_ERROR, this);
-        delete m_thread; m_thread = nullptr; return;
+        delete m_thread; m_thread = nullptr; return false;
     }
     wxMilliSleep(50);
     if (m_thread->Run() != wxTHREAD_NO_ERROR)
     {
         wxMessageBox("Cannot start reader thread.",
                      "Thread Error", wxOK | wxICON_ERROR, this);
-        delete m_thread; m_thread = nullptr; return;
+        delete m_thread; m_thread = nullptr; return false;
     }
-    SetConnected(true);
-    m_statusBar->SetStatusText("Connecting to " + device + "...", 1);
+    return true;
 }
 
 void MainFrame::OnDisconnect(wxCommandEvent&)
@@ -345,6 +414,90 @@ void MainFrame::SetConnected(bool connected)
     m_portChoice->Enable(!connected);
     m_btnRefresh->Enable(!connected);
     m_spinDelay->Enable(!connected);
+
+    // A capture file is chosen, and a replay started, only while idle.
+    if (wxMenuBar* bar = GetMenuBar())
+    {
+        bar->Enable(ID_RECORD_RAW, !connected);
+        bar->Enable(ID_REPLAY_RAW, !connected);
+    }
+}
+
+// ============================================================
+// Raw capture / replay (see RawCapture.h, ReplaySource.h)
+// ============================================================
+void MainFrame::OnRecordRaw(wxCommandEvent& evt)
+{
+    if (!evt.IsChecked())
+    {
+        m_rawCapturePath.Clear();
+        m_statusBar->SetStatusText("Raw capture off", 1);
+        return;
+    }
+
+    wxFileDialog dlg(this, "Record raw capture to", "", "Protek-506-capture.p506raw",
+                     "Raw capture (*.p506raw)|*.p506raw|All files (*.*)|*.*", wxFD_SAVE);
+    if (dlg.ShowModal() != wxID_OK)
+    {
+        GetMenuBar()->Check(ID_RECORD_RAW, false);
+        return;
+    }
+    m_rawCapturePath = dlg.GetPath();
+    m_statusBar->SetStatusText("Raw capture on next connect", 1);
+}
+
+void MainFrame::OnReplayRaw(wxCommandEvent&)
+{
+    if (m_connected) return;
+
+    wxFileDialog dlg(this, "Replay raw capture", "", "",
+                     "Raw capture (*.p506raw)|*.p506raw|All files (*.*)|*.*",
+                     wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dlg.ShowModal() != wxID_OK) return;
+
+    static const double speeds[] = { 1.0, 10.0, 100.0, 1000.0, 0.0 };
+    wxArrayString choices;
+    choices.Add("Real time (1x)");
+    choices.Add("10x");
+    choices.Add("100x");
+    choices.Add("1000x");
+    choices.Add("As fast as possible");
+    int choice = wxGetSingleChoiceIndex("Replay speed:", "Replay Raw Capture",
+                                        choices, m_replaySpeedChoice, this);
+    if (choice < 0) return;
+    m_replaySpeedChoice = choice;
+
+    if (m_thread) StopReaderThread();
+    m_alarms.Reset();
+    m_alarmsActive = 0;
+
+    // The reading path is the same as for a meter; only the source differs.
+    m_thread = new ReaderThread(this, &m_readingQueue, &m_logWriter, &m_history,
+                                &m_stats, &m_alarms, std::string(), 0);
+    m_thread->ReplayFrom(dlg.GetPath().ToStdString(), speeds[choice]);
+    m_thread->SetLatencyStats(&m_latency);
+    if (!StartReaderThread()) return;
+    SetConnected(true);
+    m_statusBar->SetStatusText("Replaying " + wxFileName(dlg.GetPath()).GetFullName() +
+                               " (" + choices[choice] + ")", 1);
+}
+
+void MainFrame::OnDiagnostics(wxCommandEvent&)
+{
+    DiagnosticsDialog dlg(this, m_latency);
+    dlg.ShowModal();
+}
+
+// The replay thread has played the whole capture.  Its last readings are
+// still queued; show them before the thread goes.
+void MainFrame::OnDmmDone(wxCommandEvent& evt)
+{
+    DrainReadings();
+    RenderFrame();
+    StopReaderThread();
+    SetConnected(false);
+    m_statusBar->SetStatusText(evt.GetInt() ? "Replay done (capture cut short)"
+                                            : "Replay done", 1);
 }
 
 // ============================================================
@@ -357,11 +510,15 @@ void MainFrame::OnToggleLog(wxCommandEvent&)
         wxString path = m_txtLogFile->GetValue();
         if (path.IsEmpty()) path = "Protek-506-log.csv";
 
-        if (!m_logger.Open(path.ToStdString()))
+        // v1.6.0: the file is written by m_logWriter's own thread, fed
+        // directly by the reader thread; see AsyncLogWriter.h.
+        m_logWriter.SetTimeFormat(m_logTimeFormat);
+        if (!m_logWriter.Open(path.ToStdString(), m_flushPolicy,
+                              m_logOverflow, m_logQueueSize))
         {
             wxMessageBox(
                 wxString::Format("Cannot open log file:\n%s\n\n%s",
-                    path, m_logger.LastError()),
+                    path, m_logWriter.LastError()),
                 "Log Error", wxICON_ERROR | wxOK, this);
             return;
         }
@@ -376,19 +533,28 @@ void MainFrame::OnToggleLog(wxCommandEvent&)
     }
     else
     {
-        m_logger.Close();
-        m_logging = false;
-        m_btnToggleLog->SetLabel("Start Logging");
-        m_btnToggleLog->SetForegroundColour(wxColour(0, 128, 0));
-        m_btnChooseFile->Enable(true);
-        m_statusBar->SetStatusText("", 2);
+        StopLogging();
     }
 }
 
+void MainFrame::StopLogging()
+{
+    m_logWriter.Close();
+    m_logging = false;
+    m_btnToggleLog->SetLabel("Start Logging");
+    m_btnToggleLog->SetForegroundColour(wxColour(0, 128, 0));
+    m_btnChooseFile->Enable(true);
+    m_statusBar->SetStatusText("", 2);
+}
+
 void MainFrame::OnChooseLogFile(wxCommandEvent&)
 {
-    wxFileDialog dlg(this, "Choose CSV log file", "", "Protek-506-log.csv",
-                     "CSV files (*.csv)|*.csv|All files (*.*)|*.*",
+    // v1.6.0: a *.p506 name selects the compact binary format; convert
+    // it with the p506tocsv tool.
+    wxFileDialog dlg(this, "Choose log file", "", "Protek-506-log.csv",
+                     "CSV files (*.csv)|*.csv|"
+                     "Binary session logs (*.p506)|*.p506|"
+                     "All files (*.*)|*.*",
                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
     if (dlg.ShowModal() == wxID_OK)
     {
@@ -399,7 +565,7 @@ void MainFrame::OnChooseLogFile(wxCommandEvent&)
 
 void MainFrame::OnClearLog(wxCommandEvent&)
 {
-    m_listLog->DeleteAllItems();
+    m_listLog->Clear();
     m_readingCount = 0;
     UpdateStatusBar();
 }
@@ -407,47 +573,162 @@ void MainFrame::OnClearLog(wxCommandEvent&)
 // ============================================================
 // Readings from the reader thread
 // ============================================================
-void MainFrame::OnDmmReading(wxCommandEvent& evt)
+
+// ----------------------------------------------------------------
+// v1.6.0: EVT_DMM_READING is only a wakeup.  Instead of handling one
+// event (and one Layout()/Refresh()) per reading, the first wakeup arms
+// a one-shot frame timer, and DrainReadings() then takes everything the
+// reader thread has queued in one batch.
+// ----------------------------------------------------------------
+void MainFrame::OnDmmReading(wxCommandEvent&)
+{
+    if (!m_frameTimer.IsRunning())
+        m_frameTimer.StartOnce(m_frameMs);
+}
+
+void MainFrame::OnFrameTimer(wxTimerEvent&)
+{
+    using namespace std::chrono;
+    auto t0 = steady_clock::now();
+
+    DrainReadings();
+    RenderFrame();
+
+    // Frame time: drain + redraw, shown in the status bar
+    long long us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+    m_frameUs = us;
+    if (us > m_frameWorstUs) m_frameWorstUs = us;
+}
+
+// ----------------------------------------------------------------
+// v1.6.0: dirty-flag renderer.  DrainReadings() only records what
+// changed; the widgets are touched here, at most once per frame tick,
+// and only if their content differs.  Layout() runs only when a
+// widget's size (or the stats panel's visibility) really changed.
+// ----------------------------------------------------------------
+void MainFrame::RenderFrame()
+{
+    if (m_dirty == 0) return;
+
+    bool layout = false;
+    if (m_dirty & DIRTY_READING)
+    {
+        layout |= DisplayReading(m_shownSample);
+        int64_t shownUs = LatencyStats::NowUs();
+        m_latency.Record(LatencyStage::Render,  m_shownTakenUs, shownUs);
+        m_latency.Record(LatencyStage::Display, m_shownSample.rxUs, shownUs);
+        m_chart->Flush();
+    }
+    if (m_dirty & DIRTY_STATS)   layout |= UpdateStatsDisplay();
+    if (m_dirty & DIRTY_STATUS)  UpdateStatusBar();
+    m_dirty = 0;
+
+    if (layout)
+    {
+        // box (GetParent()) has no sizer of its own; the sizer lives on root
+        // (GetParent()->GetParent()), so Layout() must be called there.
+        wxWindow* root = m_lblReading->GetParent()->GetParent();
+        root->Layout();
+        root->Refresh();
+    }
+}
+
+void MainFrame::DrainReadings()
 {
-    wxArrayString parts = wxSplit(evt.GetString(), '|');
-    if (parts.GetCount() < 5) return;
+    // Clear the latch first: anything pushed from here on posts a new
+    // wakeup, so a reading can never be stranded in the queue.
+    m_readingQueue.ClearSignal();
+
+    // Alarm transitions ride the same wakeup as the reading behind them.
+    AlarmEvent ev;
+    while (m_alarms.PopEvent(ev))
+        HandleAlarm(ev);
+
+    DmmSample s;
+    DmmSample last;
+    size_t    n = 0;
+    int64_t   takenUs = LatencyStats::NowUs();
+    while (n < ReadingQueue::kCapacity && m_readingQueue.TryPop(s))
+    {
+        if (s.queuedUs > 0)
+            m_latency.Record(LatencyStage::Queue, s.queuedUs, takenUs);
+        HandleSample(s);
+        last = s;
+        ++n;
+    }
+    if (n == 0) return;
+
+    // Only the newest reading is shown; stats and the log saw them all.
+    m_listLog->Flush();
+    m_shownSample  = last;
+    m_shownTakenUs = takenUs;
+    m_dirty |= DIRTY_READING | DIRTY_STATS | DIRTY_STATUS;
 
-    wxString date    = parts[0];
-    wxString time    = parts[1];
-    wxString mode    = parts[2];
-    wxString value   = parts[3];
-    wxString units   = parts[4];
-    wxString rawLine = (parts.GetCount() > 5) ? parts[5] : wxString("");
+    // Batch was capped; come back on the next tick for the rest.
+    if (!m_readingQueue.Empty() && !m_frameTimer.IsRunning())
+        m_frameTimer.StartOnce(m_frameMs);
+}
 
+void MainFrame::HandleSample(const DmmSample& s)
+{
     // NOTE: we used to strip one leading zero ("000.0" → "00.0") to
     // make readings look neater, but that broke the invariant that the
     // live display exactly mirrors the meter.  Keep the value verbatim so
     // both the UI and CSV log show the same string.
 
-    DisplayReading(mode, value, units);
-
-    if (!m_logging || !m_logger.IsOpen()) return;
-
-    m_logger.Write(date.ToStdString(), time.ToStdString(),
-                   mode.ToStdString(), value.ToStdString(),
-                   units.ToStdString(), rawLine.ToStdString());
+    // Statistics are accumulated on the reader thread (m_stats).
+    m_currentMode = s.mode;
+    m_currentUnit = s.unit;
+    m_chart->Append(s);
 
-    if (!m_logger.WriteOk())
+    // Same series rule as the chart: only a number can change it, and
+    // OL-type readings are gaps in the current one.
+    if (s.kind == DmmValueKind::Numeric)
     {
-        m_logging = false;
-        wxString err = m_logger.LastError();
-        CallAfter([this, err]() {
-            if (!IsBeingDeleted())
-                wxMessageBox("CSV write error:\n\n" + err +
-                             "\n\nLogging stopped.",
-                             "Log Write Error", wxICON_ERROR | wxOK, this);
-        });
-        return;
+        m_seriesKey  = static_cast<int>(s.mode) << 8 | static_cast<int>(DmmBaseUnit(s.unit));
+        m_seriesUnit = s.unit;
     }
+    if (m_seriesKey >= 0)
+        m_seriesHistory[m_seriesKey].Append(s.monoUs, s.kind == DmmValueKind::Numeric
+                                                          ? s.scaled
+                                                          : std::nan(""));
+
+    // The reader thread has already queued the sample for the CSV
+    // writer; the table shows the same columns, formatted on paint.
+    if (!m_logging) return;
 
-    AppendLogRow(date, time, mode, value, units, rawLine);
+    m_listLog->Append(m_readingCount + 1, s);
     ++m_readingCount;
-    UpdateStatusBar();
+}
+
+// ----------------------------------------------------------------
+// v1.6.0: an alarm rule changed state on the reader thread (see
+// AlarmEngine).  The latest transition goes in the status bar.
+// ----------------------------------------------------------------
+void MainFrame::HandleAlarm(const AlarmEvent& ev)
+{
+    wxString name = wxString::FromUTF8(m_alarms.RuleName(ev.rule));
+    wxString value;
+    if (std::isnan(ev.value))
+        value = ev.kind == DmmValueKind::Overload ? wxString("OL")
+              : ev.kind == DmmValueKind::Short    ? wxString("SHORT")
+              : ev.kind == DmmValueKind::Open     ? wxString("OPEN")
+              :                                     wxString("----");
+    else
+        value = wxString::Format("%.6g %s", ev.value / DmmUnitScale(ev.unit),
+                                 wxString::FromUTF8(DmmUnitText(ev.unit)));
+
+    if (ev.raised)
+    {
+        ++m_alarmsActive;
+        m_statusBar->SetStatusText("ALARM " + name + ": " + value, 1);
+        wxBell();
+    }
+    else
+    {
+        if (m_alarmsActive > 0) --m_alarmsActive;
+        m_statusBar->SetStatusText("Cleared " + name + ": " + value, 1);
+    }
 }
 
 void MainFrame::OnDmmError(wxCommandEvent& evt)
@@ -472,185 +753,216 @@ void MainFrame::OnDmmError(wxCommandEvent& evt)
 // ============================================================
 // Live display
 // ============================================================
-void MainFrame::DisplayReading(const wxString& modeName,
-                               const wxString& value,
-                               const wxString& units)
+bool MainFrame::DisplayReading(const DmmSample& s)
 {
-    m_currentMode  = modeName;
-    m_currentUnits = units;
+    wxString friendly = DmmModeName(s.mode);
+    switch (s.mode)
+    {
+        case DmmMode::DC:    friendly = "DC Voltage / Current"; break;
+        case DmmMode::AC:    friendly = "AC Voltage / Current"; break;
+        case DmmMode::RES:   friendly = "Resistance";           break;
+        case DmmMode::FREQ:  friendly = "Frequency";            break;
+        case DmmMode::CAP:   friendly = "Capacitance";          break;
+        case DmmMode::IND:   friendly = "Inductance";           break;
+        case DmmMode::TEMP:  friendly = "Temperature";          break;
+        case DmmMode::DIODE: friendly = "Diode";                break;
+        case DmmMode::CONT:  friendly = "Continuity";           break;
+        case DmmMode::LOGIC: friendly = "Logic Level";          break;
+        default:                                                break;
+    }
 
-    wxString friendly = modeName;
-    if      (modeName == "DC")    friendly = "DC Voltage / Current";
-    else if (modeName == "AC")    friendly = "AC Voltage / Current";
-    else if (modeName == "RES")   friendly = "Resistance";
-    else if (modeName == "FREQ")  friendly = "Frequency";
-    else if (modeName == "CAP")   friendly = "Capacitance";
-    else if (modeName == "IND")   friendly = "Inductance";
-    else if (modeName == "TEMP")  friendly = "Temperature";
-    else if (modeName == "DIODE") friendly = "Diode";
-    else if (modeName == "CONT")  friendly = "Continuity";
-    else if (modeName == "LOGIC") friendly = "Logic Level";
+    bool resized = SetLabelIfChanged(m_lblMode, friendly);
 
-    m_lblMode->SetLabel(friendly);
+    int valueLen = 0, unitsLen = 0;
+    const char* value = DmmValueText(s, valueLen);
+    const char* units = DmmUnitsText(s, unitsLen);
 
-    wxString display = value.IsEmpty() ? "----" : value;
-    if (!units.IsEmpty())
-        display += " " + units;
-    m_lblReading->SetLabel(display);
+    wxString display = valueLen == 0 ? wxString("----")
+                                     : wxString::FromUTF8(value, valueLen);
+    if (unitsLen > 0)
+        display += " " + wxString::FromUTF8(units, unitsLen);
+    resized |= SetLabelIfChanged(m_lblReading, display);
 
     wxColour col(20, 160, 20);
-    if (value == "OL" || value == "OPEN") col = wxColour(200, 120, 0);
-    else if (value == "SHORT")            col = wxColour(180,   0, 0);
-    else if (value == "High" || value == "Low" || value == "----")
-                                          col = wxColour(  0, 120, 200);
-    m_lblReading->SetForegroundColour(col);
-    m_lblMode->SetForegroundColour(wxColour(60, 60, 180));
+    switch (s.kind)
+    {
+        case DmmValueKind::Overload:
+        case DmmValueKind::Open:      col = wxColour(200, 120, 0); break;
+        case DmmValueKind::Short:     col = wxColour(180,   0, 0); break;
+        case DmmValueKind::High:
+        case DmmValueKind::Low:
+        case DmmValueKind::Undefined: col = wxColour(  0, 120, 200); break;
+        default:                                                    break;
+    }
+    SetColourIfChanged(m_lblReading, col);
+    SetColourIfChanged(m_lblMode, wxColour(60, 60, 180));
 
     // Show/hide stats group based on whether this mode supports stats.
     // Controlled at the sizer level so all child widgets participate correctly
     // in layout (avoids wxPanel-inside-wxStaticBox sizing issues on macOS).
-    bool isStat = IsStatMode(modeName);
+    bool isStat = StatsEngine::IsStatMode(s.mode);
     if (m_readingRow->IsShown(m_statsSizer) != isStat)
-        m_readingRow->Show(m_statsSizer, isStat);
-
-    // If mode became non-stat while accumulating, stop cleanly
-    if (!isStat && m_statsRunning)
     {
-        m_statsRunning = false;
-        m_btnStats->SetLabel("Start");
-    }
-
-    // If stats are running and the mode or measurement range changed, stop and reset.
-    // The context is "mode|units", which naturally distinguishes DC→AC, V↔mV, A↔mA↔µA, etc.
-    if (m_statsRunning && isStat)
-    {
-        wxString ctx = modeName + "|" + units;
-        if (ctx != m_statsContext)
-        {
-            m_statsRunning = false;
-            m_statsCount   = 0;
-            m_statsSum     = 0.0;
-            m_statsMin     = 0.0;
-            m_statsMax     = 0.0;
-            m_lblMaxVal->SetLabel("---");
-            m_lblAvgVal->SetLabel("---");
-            m_lblMinVal->SetLabel("---");
-            m_btnStats->SetLabel("Start");
-        }
-    }
-
-    // Accumulate min/avg/max if running
-    if (m_statsRunning && isStat)
-    {
-        double dval;
-        if (value.ToDouble(&dval))
-        {
-            if (m_statsCount == 0)
-            {
-                m_statsMin = dval;
-                m_statsMax = dval;
-            }
-            else
-            {
-                if (dval < m_statsMin) m_statsMin = dval;
-                if (dval > m_statsMax) m_statsMax = dval;
-            }
-            m_statsSum += dval;
-            ++m_statsCount;
-            UpdateStatsDisplay();
-        }
+        m_readingRow->Show(m_statsSizer, isStat);
+        resized = true;
     }
-
-    // box (GetParent()) has no sizer of its own; the sizer lives on root
-    // (GetParent()->GetParent()), so Layout() must be called there.
-    wxWindow* root = m_lblReading->GetParent()->GetParent();
-    root->Layout();
-    root->Refresh();
+    return resized;
 }
 
 // ============================================================
 // Stats panel helpers
 // ============================================================
-bool MainFrame::IsStatMode(const wxString& modeName) const
-{
-    return modeName == "DC"  || modeName == "AC"  ||
-           modeName == "RES" || modeName == "TEMP" ||
-           modeName == "CAP" || modeName == "IND";
-}
-
+// v1.6.0: the figures are computed on the reader thread by m_stats
+// (see StatsEngine.h); the panel only starts / stops it and shows
+// its snapshots.
 void MainFrame::OnToggleStats(wxCommandEvent&)
 {
     if (!m_statsRunning)
     {
         m_statsRunning = true;
-        m_statsContext = m_currentMode + "|" + m_currentUnits;
-        m_statsCount   = 0;
-        m_statsSum     = 0.0;
-        m_statsMin     = 0.0;
-        m_statsMax     = 0.0;
+        m_stats.Start(m_currentMode, DmmBaseUnit(m_currentUnit));
         m_lblMaxVal->SetLabel("---");
         m_lblAvgVal->SetLabel("---");
         m_lblMinVal->SetLabel("---");
+        m_lblSdVal->SetLabel("---");
+        m_lblMedVal->SetLabel("---");
+        m_histogram->Clear();
         m_btnStats->SetLabel("Stop");
     }
     else
     {
         m_statsRunning = false;
+        m_stats.Stop();
         m_btnStats->SetLabel("Start");
         // Last computed values remain displayed until Start is clicked again
     }
 }
 
-void MainFrame::UpdateStatsDisplay()
+bool MainFrame::UpdateStatsDisplay()
 {
-    if (m_statsCount == 0) return;
-    double avg = m_statsSum / static_cast<double>(m_statsCount);
-    m_lblMaxVal->SetLabel(wxString::Format("%.6g", m_statsMax));
-    m_lblAvgVal->SetLabel(wxString::Format("%.3f", avg));
-    m_lblMinVal->SetLabel(wxString::Format("%.6g", m_statsMin));
+    StatsSnapshot snap = m_stats.Snapshot();
+
+    // The engine ends a run by itself when the meter changes quantity.
+    if (m_statsRunning && !snap.running)
+    {
+        m_statsRunning = false;
+        m_btnStats->SetLabel("Start");
+    }
+
+    m_histogram->SetData(snap.histogram, m_currentUnit);
+
+    bool resized = false;
+    if (snap.count == 0)
+    {
+        for (wxStaticText* lbl : { m_lblMaxVal, m_lblAvgVal, m_lblMinVal,
+                                   m_lblSdVal, m_lblMedVal })
+            resized |= SetLabelIfChanged(lbl, "---");
+        return resized;
+    }
+
+    // Stats are kept in base units; show them in the range the meter is
+    // on now, so they read like the live value next to them.
+    double scale = DmmUnitScale(m_currentUnit);
+    resized |= SetLabelIfChanged(m_lblMaxVal, wxString::Format("%.6g", snap.max / scale));
+    resized |= SetLabelIfChanged(m_lblAvgVal, wxString::Format("%.3f", snap.mean / scale));
+    resized |= SetLabelIfChanged(m_lblMinVal, wxString::Format("%.6g", snap.min / scale));
+    resized |= SetLabelIfChanged(m_lblSdVal,  wxString::Format("%.3g", snap.stddev / scale));
+    resized |= SetLabelIfChanged(m_lblMedVal, wxString::Format("%.6g", snap.p50 / scale));
+    return resized;
 }
 
-// ============================================================
-// Log table row append
-// ============================================================
-void MainFrame::AppendLogRow(const wxString& date, const wxString& time,
-                              const wxString& mode, const wxString& reading,
-                              const wxString& units, const wxString& rawLine)
+// ----------------------------------------------------------------
+// v1.6.0: the rest of the snapshot — percentiles and the rolling
+// windows — goes in the panel's tooltip, refreshed on the 1 s tick.
+// ----------------------------------------------------------------
+void MainFrame::UpdateStatsToolTip()
 {
-    long row = m_listLog->GetItemCount();
-    if (row >= 5000)
+    StatsSnapshot snap = m_stats.Snapshot();
+    wxString tip;
+    if (snap.count > 0)
     {
-        m_listLog->DeleteItem(0);
-        row = m_listLog->GetItemCount();
+        double   scale = DmmUnitScale(m_currentUnit);
+        wxString unit  = wxString::FromUTF8(DmmUnitText(m_currentUnit));
+        tip = wxString::Format("%llu readings\n"
+                               "P1 %.6g  P50 %.6g  P99 %.6g %s\n",
+                               static_cast<unsigned long long>(snap.count),
+                               snap.p01 / scale, snap.p50 / scale, snap.p99 / scale, unit);
+        tip += wxString::Format("Last %lu: mean %.6g  sd %.3g  range %.6g .. %.6g\n",
+                                static_cast<unsigned long>(snap.windowSamples),
+                                snap.lastN.mean / scale, snap.lastN.stddev / scale,
+                                snap.lastN.min / scale, snap.lastN.max / scale);
+        tip += wxString::Format("Last %g s: mean %.6g  sd %.3g  range %.6g .. %.6g",
+                                snap.windowUs / 1e6,
+                                snap.lastT.mean / scale, snap.lastT.stddev / scale,
+                                snap.lastT.min / scale, snap.lastT.max / scale);
+    }
+
+    // The last hour and day of this series, from its HistoryPyramid's
+    // buckets (a few thousand at most), in the range last shown.
+    auto it = m_seriesHistory.find(m_seriesKey);
+    if (it != m_seriesHistory.end() && !it->second.Empty())
+    {
+        const HistoryPyramid& h = it->second;
+        double   scale = DmmUnitScale(m_seriesUnit);
+        int64_t  now   = h.LastUs();
+        for (int hours : { 1, 24 })
+        {
+            HistoryBucket b;
+            if (!h.Summary(now - hours * 3600LL * 1000000, now, b))
+                continue;
+            if (!tip.empty()) tip += "\n";
+            tip += wxString::Format("Last %d h: mean %.6g  range %.6g .. %.6g  (%u readings",
+                                    hours, b.Mean() / scale,
+                                    b.minValue / scale, b.maxValue / scale, b.count);
+            tip += b.other > 0 ? wxString::Format(", %u OL etc.)", b.other) : wxString(")");
+        }
     }
+    if (tip == m_statsTip) return;
+    m_statsTip = tip;
+    for (wxStaticText* lbl : { m_lblMaxVal, m_lblAvgVal, m_lblMinVal,
+                               m_lblSdVal, m_lblMedVal })
+        lbl->SetToolTip(tip);
+}
 
-    // InsertItem returns -1 on failure; guard all subsequent calls.
-    long idx = m_listLog->InsertItem(row,
-                   wxString::Format("%ld", m_readingCount + 1));
-    if (idx < 0) return;
+void MainFrame::OnExportStats(wxCommandEvent&)
+{
+    StatsSnapshot snap = m_stats.Snapshot();
+    if (snap.count == 0)
+    {
+        wxMessageBox("No statistics have been collected yet.\n\n"
+                     "Press Start in the Live Reading panel first.",
+                     "Export Statistics", wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+    wxFileDialog dlg(this, "Export statistics", "", "Protek-506-stats.csv",
+                     "CSV files (*.csv)|*.csv|All files (*.*)|*.*",
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dlg.ShowModal() != wxID_OK) return;
 
-    m_listLog->SetItem(idx, 1, date);
-    m_listLog->SetItem(idx, 2, time);
-    m_listLog->SetItem(idx, 3, mode);
-    m_listLog->SetItem(idx, 4, reading);
-    m_listLog->SetItem(idx, 5, units);
-    m_listLog->SetItem(idx, 6, rawLine);
+    if (!StatsEngine::ExportCsv(snap, dlg.GetPath().ToStdString()))
+        wxMessageBox("Cannot write file:\n" + dlg.GetPath(),
+                     "Export Statistics", wxOK | wxICON_ERROR, this);
+}
 
-    // Dark-mode-safe alternating row colours from system palette
-    wxColour base   = wxSystemSettings::GetColour(wxSYS_COLOUR_LISTBOX);
-    wxColour text   = wxSystemSettings::GetColour(wxSYS_COLOUR_LISTBOXTEXT);
-    wxColour accent = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW);
+void MainFrame::OnExportHistogram(wxCommandEvent&)
+{
+    StatsSnapshot snap = m_stats.Snapshot();
+    if (snap.histogram.total == 0)
+    {
+        wxMessageBox("No histogram has been collected yet.\n\n"
+                     "Press Start in the Live Reading panel first.",
+                     "Export Histogram", wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+    wxFileDialog dlg(this, "Export histogram", "", "Protek-506-histogram.csv",
+                     "CSV files (*.csv)|*.csv|All files (*.*)|*.*",
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dlg.ShowModal() != wxID_OK) return;
 
-    auto blend = [](wxColour a, wxColour b, double t) -> wxColour {
-        return wxColour(
-            static_cast<unsigned char>(a.Red()   * (1-t) + b.Red()   * t),
-            static_cast<unsigned char>(a.Green() * (1-t) + b.Green() * t),
-            static_cast<unsigned char>(a.Blue()  * (1-t) + b.Blue()  * t));
-    };
-    wxColour stripe = blend(base, accent, 0.35);
-    m_listLog->SetItemBackgroundColour(idx, (idx % 2 == 0) ? stripe : base);
-    m_listLog->SetItemTextColour(idx, text);
-    m_listLog->EnsureVisible(idx);
+    if (!StreamHistogram::ExportCsv(snap.histogram, m_currentUnit,
+                                    dlg.GetPath().ToStdString()))
+        wxMessageBox("Cannot write file:\n" + dlg.GetPath(),
+                     "Export Histogram", wxOK | wxICON_ERROR, this);
 }
 
 // ============================================================
@@ -658,18 +970,102 @@ void MainFrame::AppendLogRow(const wxString& date, const wxString& time,
 // ============================================================
 void MainFrame::UpdateStatusBar()
 {
-    m_statusBar->SetStatusText(
-        wxString::Format("Readings: %ld", m_readingCount), 0);
+    wxString text = wxString::Format("Readings: %ld", m_readingCount);
+
+    // Polls skipped because a cycle overran its deadline (slow reply,
+    // timeout) — only shown once it has happened.
+    unsigned long long missed = m_thread ? m_thread->MissedDeadlines() : 0;
+    if (missed > 0)
+        text += wxString::Format("  (missed polls: %llu)", missed);
+
+    // Replies the stream parser had to throw away — only shown if any.
+    unsigned long long garbled = m_thread ? m_thread->GarbledFrames() : 0;
+    if (garbled > 0)
+        text += wxString::Format("  (garbled: %llu)", garbled);
+
+    // Reader → GUI queue: current depth and peak; drops only if any.
+    text += wxString::Format("  Queue: %lu (peak %lu)",
+                             static_cast<unsigned long>(m_readingQueue.Depth()),
+                             static_cast<unsigned long>(m_readingQueue.HighWater()));
+    unsigned long long dropped = m_readingQueue.Dropped();
+    if (dropped > 0)
+        text += wxString::Format(", dropped %llu", dropped);
+
+    // In-memory history (see SeriesStore)
+    uint64_t stored = m_history.SampleCount();
+    if (stored > 0)
+        text += wxString::Format("  History: %llu KiB",
+                                 static_cast<unsigned long long>(
+                                     (m_history.BytesUsed() + 1023) / 1024));
+
+    // Raw capture being recorded, or replay progress
+    if (m_thread && m_thread->Replaying())
+    {
+        uint64_t size = m_thread->ReplaySize();
+        if (size > 0)
+            text += wxString::Format("  Replay: %.0f%%",
+                                     100.0 * m_thread->ReplayPosition() / size);
+    }
+    else if (m_thread && !m_rawCapturePath.IsEmpty())
+    {
+        if (m_thread->CaptureFailed())
+            text += "  Raw: FAILED";
+        else
+            text += wxString::Format("  Raw: %llu KiB",
+                                     static_cast<unsigned long long>(
+                                         (m_thread->CaptureBytes() + 1023) / 1024));
+    }
+
+    // Alarm rules: active count and trigger latency, once any has fired
+    if (m_alarms.Events() > 0)
+        text += wxString::Format("  Alarms: %d active, %lld us (worst %lld)",
+                                 m_alarmsActive,
+                                 static_cast<long long>(m_alarms.LastLatencyUs()),
+                                 static_cast<long long>(m_alarms.WorstLatencyUs()));
+
+    // Live display cost: last frame and worst in the past second
+    if (m_frameUs > 0)
+        text += wxString::Format("  Frame: %.1f ms (worst %.1f)",
+                                 m_frameUs / 1000.0, m_frameWorstUs / 1000.0);
+
+    if (m_statusBar->GetStatusText(0) != text)
+        m_statusBar->SetStatusText(text, 0);
 }
 
 void MainFrame::OnTimer(wxTimerEvent&)
 {
     UpdateStatusBar();
-    if (m_logging && m_logger.IsOpen())
-        m_statusBar->SetStatusText(
-            wxString::Format("Logging (%ld rows) -> %s",
-                m_logger.RowCount(),
-                wxFileName(m_txtLogFile->GetValue()).GetFullName()), 2);
+    UpdateStatsToolTip();
+    m_frameWorstUs = 0;
+    if (m_logging && m_logWriter.IsOpen())
+    {
+        wxString text = wxString::Format(
+            "Logging (%ld rows, %llu KiB, %llu flushes, worst %.1f ms",
+            m_logWriter.RowCount(),
+            static_cast<unsigned long long>(m_logWriter.BytesWritten() / 1024),
+            static_cast<unsigned long long>(m_logWriter.FlushCount()),
+            m_logWriter.WorstFlushUs() / 1000.0);
+        // Writer queue overflow — only shown if it has happened
+        unsigned long long dropped = m_logWriter.Dropped();
+        unsigned long long spilled = m_logWriter.Spilled();
+        if (dropped > 0) text += wxString::Format(", dropped %llu", dropped);
+        if (spilled > 0) text += wxString::Format(", spilled %llu", spilled);
+        text += ") -> " + wxFileName(m_txtLogFile->GetValue()).GetFullName();
+        m_statusBar->SetStatusText(text, 2);
+    }
+}
+
+// ----------------------------------------------------------------
+// v1.6.0: the CSV writer thread failed (disk full, I/O error, ...).
+// It has already stopped writing; stop logging and tell the user.
+// ----------------------------------------------------------------
+void MainFrame::OnLogError(wxCommandEvent& evt)
+{
+    if (!m_logging) return;
+    StopLogging();
+    wxMessageBox("CSV write error:\n\n" + evt.GetString() +
+                 "\n\nLogging stopped.",
+                 "Log Write Error", wxICON_ERROR | wxOK, this);
 }
 
 // ============================================================
@@ -698,6 +1094,33 @@ void MainFrame::SaveSettings()
                   cd ? cd->GetData() : m_portChoice->GetStringSelection());
     }
     cfg.Write("/Logging/LastFile", m_txtLogFile->GetValue());
+
+    // v1.6.0: log durability policy (see LogFlushPolicy)
+    cfg.Write("/Logging/FlushEveryRows", m_flushPolicy.everyRows);
+    cfg.Write("/Logging/FlushEveryMs",   m_flushPolicy.everyMs);
+    cfg.Write("/Logging/SyncEveryMs",    m_flushPolicy.syncMs);
+
+    // v1.6.0: writer-thread queue (see AsyncLogWriter)
+    static const char* const overflowNames[] = { "block", "drop", "spill" };
+    cfg.Write("/Logging/QueueSize", static_cast<long>(m_logQueueSize));
+    cfg.Write("/Logging/QueueFull",
+              wxString(overflowNames[static_cast<int>(m_logOverflow)]));
+    cfg.Write("/Logging/TimeFormat",
+              wxString(TimestampFormatter::FormatName(m_logTimeFormat)));
+
+    // v1.6.0: rows kept in the Reading Log table (see ReadingTable)
+    cfg.Write("/Display/TableRows", static_cast<long>(m_listLog->Capacity()));
+    cfg.Write("/Display/MaxFps",    static_cast<long>(m_maxFps));
+    cfg.Write("/Display/ChartPoints", static_cast<long>(m_chart->Capacity()));
+
+    // v1.6.0: rolling statistics windows (see StatsEngine)
+    cfg.Write("/Stats/WindowSamples", m_statsWindowSamples);
+    cfg.Write("/Stats/WindowSeconds", m_statsWindowSeconds);
+
+    // v1.6.0: alarm rules, written back as they were read (see AlarmEngine)
+    for (size_t i = 0; i < m_alarmRules.size(); ++i)
+        cfg.Write(wxString::Format("/Alarms/Rule%lu", static_cast<unsigned long>(i + 1)),
+                  m_alarmRules[i]);
     cfg.Flush();
 }
 
@@ -720,6 +1143,98 @@ void MainFrame::LoadSettings()
     wxString lastFile;
     if (cfg.Read("/Logging/LastFile", &lastFile) && !lastFile.IsEmpty())
         m_txtLogFile->SetValue(lastFile);
+
+    // Defaults keep the pre-1.6.0 behaviour: flush every row, no sync.
+    LogFlushPolicy fp;
+    fp.everyRows = static_cast<int>(cfg.ReadLong("/Logging/FlushEveryRows", fp.everyRows));
+    fp.everyMs   = static_cast<int>(cfg.ReadLong("/Logging/FlushEveryMs",   fp.everyMs));
+    fp.syncMs    = static_cast<int>(cfg.ReadLong("/Logging/SyncEveryMs",    fp.syncMs));
+    if (fp.everyRows < 0) fp.everyRows = 0;
+    if (fp.everyMs   < 0) fp.everyMs   = 0;
+    if (fp.syncMs    < 0) fp.syncMs    = 0;
+    if (fp.everyRows == 0 && fp.everyMs == 0)
+        fp.everyRows = 1;       // never flushing is not a policy
+    m_flushPolicy = fp;
+
+    long queueSize = cfg.ReadLong("/Logging/QueueSize", static_cast<long>(m_logQueueSize));
+    if (queueSize >= 16 && queueSize <= 1048576)
+        m_logQueueSize = static_cast<size_t>(queueSize);
+    wxString full = cfg.Read("/Logging/QueueFull", wxString("block")).Lower();
+    if      (full == "drop")  m_logOverflow = LogOverflow::DropOldest;
+    else if (full == "spill") m_logOverflow = LogOverflow::Spill;
+    else                      m_logOverflow = LogOverflow::Block;
+
+    // CSV time column: "tenths" (default), "ms" or "us"
+    wxString timeFormat = cfg.Read("/Logging/TimeFormat", wxString("tenths")).Lower();
+    if (!TimestampFormatter::FormatFromName(timeFormat.ToStdString(), m_logTimeFormat))
+        m_logTimeFormat = LogTimeFormat::Tenths;
+
+    // v1.6.0: live display redraw cap
+    long fps = cfg.ReadLong("/Display/MaxFps", DEFAULT_FPS);
+    if (fps < 1)   fps = 1;
+    if (fps > 120) fps = 120;
+    m_maxFps  = static_cast<int>(fps);
+    m_frameMs = 1000 / m_maxFps;
+
+    long tableRows = cfg.ReadLong("/Display/TableRows",
+                                  static_cast<long>(ReadingTable::kDefaultCapacity));
+    if (tableRows >= 100 && tableRows <= 50000000 &&
+        static_cast<size_t>(tableRows) != m_listLog->Capacity())
+        m_listLog->SetCapacity(static_cast<size_t>(tableRows));
+
+    long chartPoints = cfg.ReadLong("/Display/ChartPoints",
+                                    static_cast<long>(StripChart::kDefaultCapacity));
+    if (chartPoints >= 1024 && chartPoints <= 50000000 &&
+        static_cast<size_t>(chartPoints) != m_chart->Capacity())
+        m_chart->SetCapacity(static_cast<size_t>(chartPoints));
+
+    long winSamples = cfg.ReadLong("/Stats/WindowSamples", m_statsWindowSamples);
+    long winSeconds = cfg.ReadLong("/Stats/WindowSeconds", m_statsWindowSeconds);
+    if (winSamples >= 2 && winSamples <= 1000000) m_statsWindowSamples = winSamples;
+    if (winSeconds >= 1 && winSeconds <= 86400)   m_statsWindowSeconds = winSeconds;
+    m_stats.SetWindows(static_cast<size_t>(m_statsWindowSamples),
+                       static_cast<int64_t>(m_statsWindowSeconds) * 1000000);
+
+    // Alarm rules: Rule1, Rule2, ... up to the first missing key.  A rule
+    // that does not compile is kept in the file but not evaluated.
+    m_alarmRules.clear();
+    m_alarms.ClearRules();
+    wxString bad;
+    for (int i = 1; i <= AlarmEngine::kMaxRules; ++i)
+    {
+        wxString spec;
+        if (!cfg.Read(wxString::Format("/Alarms/Rule%d", i), &spec)) break;
+        m_alarmRules.push_back(spec);
+        if (!m_alarms.AddRule(spec.ToStdString()))
+            bad += wxString::Format("\nRule%d: %s", i, m_alarms.LastError());
+    }
+    if (!bad.IsEmpty())
+        CallAfter([this, bad]() {
+            wxMessageBox("Some alarm rules in the INI file were ignored:\n" + bad,
+                         "Alarm Rules", wxOK | wxICON_WARNING, this);
+        });
+}
+
+// ============================================================
+// v1.6.0: History
+// ============================================================
+void MainFrame::OnSaveHistory(wxCommandEvent&)
+{
+    if (m_history.SampleCount() == 0)
+    {
+        wxMessageBox("No readings have been received yet.",
+                     "Save History", wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+    wxFileDialog dlg(this, "Save history", "", "Protek-506-history.p506h",
+                     "History files (*.p506h)|*.p506h|All files (*.*)|*.*",
+                     wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dlg.ShowModal() != wxID_OK) return;
+
+    wxBusyCursor busy;
+    if (!m_history.Save(dlg.GetPath().ToStdString()))
+        wxMessageBox("Cannot save history:\n\n" + wxString(m_history.LastError()),
+                     "Save History", wxOK | wxICON_ERROR, this);
 }
 
 // ============================================================
@@ -749,7 +1264,7 @@ void MainFrame::OnClose(wxCloseEvent& evt)
 {
     SaveSettings();
     StopReaderThread();
-    if (m_logging) m_logger.Close();
+    if (m_logging) m_logWriter.Close();
     evt.Skip();
 }
 
@@ -760,15 +1275,28 @@ void MainFrame::BuildMenuBar()
 {
     wxMenuBar* bar = new wxMenuBar;
 
-#ifndef __WXMAC__
-    // On macOS, wxID_EXIT is moved automatically to the application menu,
-    // leaving the File menu empty — so we omit it on that platform.
     wxMenu* fileMenu = new wxMenu;
+    fileMenu->Append(ID_SAVE_HISTORY, "Save &History...\tCtrl+S",
+                     "Save every reading of this run (compressed)");
+    fileMenu->Append(ID_EXPORT_STATS, "Export &Statistics...",
+                     "Write the current statistics to a CSV file");
+    fileMenu->Append(ID_EXPORT_HISTOGRAM, "Export Histo&gram...",
+                     "Write the current histogram to a CSV file");
+    fileMenu->AppendSeparator();
+    fileMenu->AppendCheckItem(ID_RECORD_RAW, "&Record Raw Capture...",
+                              "Record every byte from the meter, from the next connect");
+    fileMenu->Append(ID_REPLAY_RAW, "Re&play Raw Capture...",
+                     "Feed a raw capture through the display, stats and log again");
+#ifndef __WXMAC__
+    // On macOS, wxID_EXIT is moved automatically to the application menu.
+    fileMenu->AppendSeparator();
     fileMenu->Append(wxID_EXIT, "E&xit\tCtrl+Q");
-    bar->Append(fileMenu, "&File");
 #endif
+    bar->Append(fileMenu, "&File");
 
     wxMenu* helpMenu = new wxMenu;
+    helpMenu->Append(ID_DIAGNOSTICS, "&Diagnostics...",
+                     "Latency of each stage from the meter to the screen and the log");
     helpMenu->Append(wxID_ABOUT, "&About...");
     // On macOS, wxID_ABOUT is also relocated to the application menu;
     // the Help menu keeps the system search field, which is correct HIG behaviour.
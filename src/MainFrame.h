@@ -13,9 +13,19 @@
 #include <wx/fileconf.h>   // wxFileConfig — INI persistence
 #include <wx/filename.h>
 #include <wx/stdpaths.h>
+#include <map>
 #include <memory>
+#include <vector>
 #include "ReaderThread.h"
 #include "CsvLogger.h"
+#include "AsyncLogWriter.h"
+#include "SeriesStore.h"
+#include "ReadingTable.h"
+#include "StripChart.h"
+#include "HistoryPyramid.h"
+#include "StatsEngine.h"
+#include "HistogramPanel.h"
+#include "LatencyStats.h"
 #include "Events.h"
 
 class MainFrame : public wxFrame
@@ -42,24 +52,34 @@ private:
     void OnChooseLogFile(wxCommandEvent& evt);
     void OnClearLog(wxCommandEvent& evt);
     void OnRefreshPorts(wxCommandEvent& evt);
+    void OnSaveHistory(wxCommandEvent& evt);
+    void OnExportStats(wxCommandEvent& evt);
+    void OnExportHistogram(wxCommandEvent& evt);
+    void OnRecordRaw(wxCommandEvent& evt);
+    void OnReplayRaw(wxCommandEvent& evt);
+    void OnDiagnostics(wxCommandEvent& evt);
     void OnAbout(wxCommandEvent& evt);
     void OnExit(wxCommandEvent& evt);
     void OnClose(wxCloseEvent& evt);
     void OnDmmReading(wxCommandEvent& evt);
     void OnDmmError(wxCommandEvent& evt);
+    void OnDmmDone(wxCommandEvent& evt);
+    void OnLogError(wxCommandEvent& evt);
     void OnTimer(wxTimerEvent& evt);
+    void OnFrameTimer(wxTimerEvent& evt);
 
     // ---- helpers ----
-    void AppendLogRow(const wxString& date, const wxString& time,
-                      const wxString& mode, const wxString& reading,
-                      const wxString& units, const wxString& rawLine);
-    void DisplayReading(const wxString& modeName,
-                        const wxString& value,
-                        const wxString& units);
+    void DrainReadings();
+    void HandleSample(const DmmSample& s);
+    void HandleAlarm(const AlarmEvent& ev);
+    void StopLogging();
+    bool DisplayReading(const DmmSample& s);     // true: needs Layout()
+    void RenderFrame();
+    bool StartReaderThread();                    // runs m_thread; false: deleted
     void StopReaderThread();
     void OnToggleStats(wxCommandEvent& evt);
-    void UpdateStatsDisplay();
-    bool IsStatMode(const wxString& modeName) const;
+    bool UpdateStatsDisplay();                   // true: needs Layout()
+    void UpdateStatsToolTip();
 
     // ---- INI persistence ----
     void SaveSettings();
@@ -84,34 +104,71 @@ private:
     wxStaticText*  m_lblMaxVal        = nullptr;
     wxStaticText*  m_lblAvgVal        = nullptr;
     wxStaticText*  m_lblMinVal        = nullptr;
+    wxStaticText*  m_lblSdVal         = nullptr;
+    wxStaticText*  m_lblMedVal        = nullptr;
+    HistogramPanel* m_histogram       = nullptr;
+
+    // Trend chart
+    StripChart*    m_chart            = nullptr;
 
     // Log controls
     wxButton*      m_btnToggleLog     = nullptr;
     wxButton*      m_btnChooseFile    = nullptr;
     wxButton*      m_btnClearLog      = nullptr;
     wxTextCtrl*    m_txtLogFile       = nullptr;
-    wxListCtrl*    m_listLog          = nullptr;
+    ReadingTable*  m_listLog          = nullptr;   // virtual; rows live in its ring
 
     wxStatusBar*   m_statusBar        = nullptr;
     wxTimer        m_timer;
+    wxTimer        m_frameTimer;           // one-shot, drains m_readingQueue
+    int            m_maxFps           = 30;    // [Display] MaxFps, as configured
+    int            m_frameMs          = 33;    // 1000 / m_maxFps
+
+    // v1.6.0: dirty-flag renderer (see RenderFrame)
+    enum { DIRTY_READING = 1, DIRTY_STATS = 2, DIRTY_STATUS = 4 };
+    unsigned       m_dirty            = 0;
+    DmmSample      m_shownSample;          // newest reading, for the live display
+    int64_t        m_shownTakenUs     = 0; // when DrainReadings() took it (LatencyStats)
+    long long      m_frameUs          = 0; // last drain + render
+    long long      m_frameWorstUs     = 0; // worst since the last 1 s tick
 
     // ---- state ----
     ReaderThread*  m_thread           = nullptr;
-    CsvLogger      m_logger;
+    ReadingQueue   m_readingQueue;         // filled by m_thread, drained on the frame tick
+    LatencyStats   m_latency;              // per-stage timings (Help > Diagnostics)
+    AsyncLogWriter m_logWriter;            // CSV file, written on its own thread
+    SeriesStore    m_history;              // every reading this run, compressed
+    LogFlushPolicy m_flushPolicy;          // from the INI file
+    LogOverflow    m_logOverflow      = LogOverflow::Block;
+    size_t         m_logQueueSize     = 4096;
+    LogTimeFormat  m_logTimeFormat    = LogTimeFormat::Tenths;
     bool           m_connected        = false;
     bool           m_logging          = false;
     long           m_readingCount     = 0;
     wxString       m_lastRawLine;
+    wxString       m_rawCapturePath;       // File > Record Raw Capture; empty: off
+    int            m_replaySpeedChoice = 0;  // last choice in the replay dialog
 
     // Stats accumulation state
-    bool           m_statsRunning     = false;
-    double         m_statsMin         = 0.0;
-    double         m_statsMax         = 0.0;
-    double         m_statsSum         = 0.0;
-    long           m_statsCount       = 0;
-    wxString       m_currentMode;          // mode name from last reading
-    wxString       m_currentUnits;         // units from last reading
-    wxString       m_statsContext;         // mode|units snapshot taken when stats were started
+    StatsEngine    m_stats;                // fed by the reader thread
+    bool           m_statsRunning     = false;  // button state
+    long           m_statsWindowSamples = 100;  // [Stats] WindowSamples
+    long           m_statsWindowSeconds = 60;   // [Stats] WindowSeconds
+    wxString       m_statsTip;
+    DmmMode        m_currentMode      = DmmMode::Unknown;  // mode of last reading
+    DmmUnit        m_currentUnit      = DmmUnit::None;     // units of last reading
+
+    // v1.6.0: long-range history per series (mode + base unit) for the
+    // 1 h / 24 h lines of the stats tooltip.  Unlike the chart's, it is
+    // kept when the meter changes mode or range and back.
+    std::map<int, HistoryPyramid> m_seriesHistory;
+    int            m_seriesKey        = -1;    // series of the last numeric reading
+    DmmUnit        m_seriesUnit       = DmmUnit::None;  // and its unit
+
+    // Alarm rules, evaluated by the reader thread
+    AlarmEngine    m_alarms;
+    std::vector<wxString> m_alarmRules;    // [Alarms] RuleN, as read
+    int            m_alarmsActive     = 0;
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -126,5 +183,12 @@ enum
     ID_CLEAR_LOG,
     ID_REFRESH_PORTS,
     ID_TIMER,
+    ID_FRAME_TIMER,
+    ID_SAVE_HISTORY,
+    ID_EXPORT_STATS,
+    ID_EXPORT_HISTOGRAM,
     ID_TOGGLE_STATS,
+    ID_RECORD_RAW,
+    ID_REPLAY_RAW,
+    ID_DIAGNOSTICS,
 };
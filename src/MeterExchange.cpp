@@ -0,0 +1,81 @@
+// ============================================================
+//  Protek506Logger — MeterExchange.cpp
+// ============================================================
+#include "MeterExchange.h"
+
+MeterExchange::MeterExchange() {}
+
+bool MeterExchange::StartCapture(const std::string& path)
+{
+    m_clock.AnchorNow();
+    if (!m_capture.Open(path, m_clock.WallAnchorUs(), m_clock.MonoAnchorUs()))
+    {
+        m_captureError = "Cannot record raw capture: " + m_capture.LastError();
+        return false;
+    }
+    m_captureBytes.store(m_capture.BytesWritten(), std::memory_order_relaxed);
+    return true;
+}
+
+void MeterExchange::Capture(rawcap::Type type, int64_t monoUs, const uint8_t* data, size_t len)
+{
+    if (!m_capture.IsOpen()) return;
+    if (!m_capture.Write(type, monoUs, data, len))
+    {
+        m_captureError = "Raw capture stopped: " + m_capture.LastError();
+        m_captureFailed.store(true, std::memory_order_release);
+        return;
+    }
+    m_captureBytes.store(m_capture.BytesWritten(), std::memory_order_relaxed);
+}
+
+void MeterExchange::Connected()
+{
+    // Readings are dated on the steady clock from here on
+    if (!m_capture.IsOpen())
+        m_clock.AnchorNow();
+    m_clock.Reset();
+}
+
+// ----------------------------------------------------------------
+// Exchange
+// ----------------------------------------------------------------
+void MeterExchange::Triggered(int64_t monoUs, uint8_t trigger)
+{
+    m_triggerUs    = monoUs;
+    m_firstUs      = 0;
+    m_framesBefore = m_stream.FramesEnded();
+    m_clock.Trigger(monoUs);
+    Capture(rawcap::Type::Tx, monoUs, &trigger, 1);
+}
+
+// v1.6.0: bytes go from the port's receive ring straight through the
+// stream parser; a reading is handed on the moment its CR is seen
+// instead of after a line has been assembled, trimmed and split.
+void MeterExchange::Received(const uint8_t* data, size_t len, int64_t monoUs)
+{
+    if (m_firstUs == 0) m_firstUs = monoUs;
+    Capture(rawcap::Type::Rx, monoUs, data, len);
+    m_clock.Received(monoUs, len);
+
+    m_stream.Feed(data, len, [this](DmmSample& s)
+    {
+        m_clock.Stamp(s, m_stream.CrOffset());
+
+        // Once per trigger: the reply's wait and its transfer time
+        if (m_latency && m_triggerUs > 0)
+        {
+            m_latency->Record(LatencyStage::Reply,   m_triggerUs, m_firstUs);
+            m_latency->Record(LatencyStage::Receive, m_firstUs, s.rxUs);
+            m_triggerUs = 0;
+        }
+        if (m_onReading)
+            m_onReading(s);
+    });
+}
+
+void MeterExchange::Abandon()
+{
+    m_stream.Reset();
+    m_clock.Reset();
+}
@@ -0,0 +1,96 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — MeterExchange.h
+//  One meter's side of the trigger / reply exchange, shared by
+//  the two polling loops: MeterPoller (one thread per meter,
+//  blocking reads) and AcquisitionEngine (one epoll thread for
+//  many meters).  The loops decide when to trigger and how to
+//  wait for bytes; everything that happens to the bytes is
+//  here, so both date, parse, record and time readings alike:
+//
+//    - the DmmStreamParser, fed straight from the receive ring;
+//    - the AcqClock that dates each reading on the wire;
+//    - the optional raw capture of triggers and received bytes;
+//    - the Reply and Receive latency stages;
+//    - the end of an exchange: a frame ended, whether the parser
+//      emitted it or rejected it.
+//
+//  Not thread-safe: it belongs to the thread that polls the
+//  meter.  GarbledFrames() and the capture counters may be read
+//  from any thread.
+// ============================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "DmmParser.h"
+#include "DmmStreamParser.h"
+#include "RawCapture.h"
+#include "AcqClock.h"
+#include "LatencyStats.h"
+
+class MeterExchange
+{
+public:
+    // Called on the polling thread with the timestamps filled in.
+    using ReadingHandler = std::function<void(DmmSample& s)>;
+
+    MeterExchange();
+
+    MeterExchange(const MeterExchange&) = delete;
+    MeterExchange& operator=(const MeterExchange&) = delete;
+
+    // Set before polling starts; not synchronised.
+    void SetReadingHandler(ReadingHandler fn) { m_onReading = std::move(fn); }
+    void SetLatencyStats(LatencyStats* stats) { m_latency = stats; }
+
+    // Record the traffic to 'path' (appended; see RawCapture.h), its
+    // session block carrying the clock anchor.  False with
+    // CaptureError() set if the file cannot be opened.
+    bool StartCapture(const std::string& path);
+    void StopCapture() { m_capture.Close(); }
+
+    // The port was (re)opened: anchor the clock, unless a capture
+    // started first has done so in its session block.
+    void Connected();
+
+    // The trigger went out at monoUs (AcqClock::NowUs()).
+    void Triggered(int64_t monoUs, uint8_t trigger);
+
+    // 'len' bytes were taken from the port at monoUs: capture them,
+    // parse them and hand on each reading whose CR is among them.
+    void Received(const uint8_t* data, size_t len, int64_t monoUs);
+
+    // True once the reply to the last trigger is over: a frame has
+    // ended since, emitted or rejected.
+    bool ReplyEnded() const { return m_stream.FramesEnded() != m_framesBefore; }
+
+    // The reply timed out: drop the half-received frame (counted as
+    // garbled); the next reply cannot finish it.
+    void Abandon();
+
+    // Replies discarded as garbled (any thread)
+    uint64_t GarbledFrames() const { return m_stream.Garbled(); }
+
+    // Raw capture progress (any thread).  CaptureError() is written
+    // once, before CaptureFailed() turns true.
+    uint64_t    CaptureBytes()  const { return m_captureBytes.load(std::memory_order_relaxed); }
+    bool        CaptureFailed() const { return m_captureFailed.load(std::memory_order_acquire); }
+    std::string CaptureError()  const { return m_captureError; }
+
+private:
+    void Capture(rawcap::Type type, int64_t monoUs, const uint8_t* data, size_t len);
+
+    DmmStreamParser     m_stream;
+    AcqClock            m_clock;
+    ReadingHandler      m_onReading;
+    LatencyStats*       m_latency      = nullptr;
+    int64_t             m_triggerUs    = 0;     // last trigger; 0 once its reply is timed
+    int64_t             m_firstUs      = 0;     // first byte after it
+    uint64_t            m_framesBefore = 0;     // FramesEnded() at the trigger
+    RawCaptureWriter    m_capture;              // open only while recording
+    std::atomic<uint64_t> m_captureBytes{0};
+    std::atomic<bool>   m_captureFailed{false};
+    std::string         m_captureError;
+};
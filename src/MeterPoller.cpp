@@ -0,0 +1,114 @@
+// ============================================================
+//  Protek506Logger — MeterPoller.cpp
+// ============================================================
+#include "MeterPoller.h"
+
+MeterPoller::MeterPoller() {}
+
+std::string MeterPoller::LastError() const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_lastError.empty())
+            return m_lastError;
+    }
+    return m_exchange.CaptureFailed() ? m_exchange.CaptureError() : std::string();
+}
+
+void MeterPoller::SetError(const std::string& msg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastError = msg;
+}
+
+bool MeterPoller::Open(const std::string& device)
+{
+    m_exchange.Connected();
+    if (!m_serial.Open(device, 1200, 7, 2, 'N', 1000))
+    {
+        SetError("Cannot open port " + device + ": " + m_serial.LastError());
+        return false;
+    }
+    return true;
+}
+
+bool MeterPoller::StartCapture(const std::string& path)
+{
+    if (!m_exchange.StartCapture(path))
+    {
+        SetError(m_exchange.CaptureError());
+        return false;
+    }
+    return true;
+}
+
+void MeterPoller::Stop()
+{
+    m_scheduler.Stop();
+}
+
+// ----------------------------------------------------------------
+// Poll loop
+// ----------------------------------------------------------------
+bool MeterPoller::Run(int pollDelayMs)
+{
+    if (!m_scheduler.Start(pollDelayMs))
+    {
+        SetError("Cannot create poll timer");
+        m_serial.Close();
+        return false;
+    }
+
+    // v1.6.0: triggers are sent on absolute deadlines (start + k * delay)
+    // instead of sleeping pollDelayMs after each cycle, so the serial
+    // round-trip and parse time no longer stretch the sample period.
+    bool ok = true;
+    while (m_scheduler.WaitNext())
+    {
+        static const uint8_t trigger = '\n';
+        m_serial.WriteByte(trigger);            // Trigger every cycle
+        m_exchange.Triggered(AcqClock::NowUs(), trigger);
+
+        if (!AwaitReading())
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    m_serial.Close();
+    m_exchange.StopCapture();
+    return ok;
+}
+
+// The exchange is over when a frame ends, whether the parser emitted it
+// or rejected it; a garbled reply does not wait out the read timeout.
+// Returns false on a serial error (LastError() set).
+bool MeterPoller::AwaitReading()
+{
+    for (;;)
+    {
+        size_t len = 0;
+        const uint8_t* data;
+        while ((data = m_serial.PeekInput(len)), len > 0)
+        {
+            m_exchange.Received(data, len, AcqClock::NowUs());
+            m_serial.ConsumeInput(len);
+        }
+        if (m_exchange.ReplyEnded()) return true;
+
+        int n = m_serial.WaitInput();
+        if (n < 0)
+        {
+            SetError("Serial read error: " + m_serial.LastError());
+            return false;
+        }
+        if (n == 0)
+        {
+            // Timeout / EOF: a half-received reply cannot be finished by
+            // the next one, so drop it (counted as garbled).
+            m_exchange.Abandon();
+            return true;
+        }
+    }
+}
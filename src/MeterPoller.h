@@ -0,0 +1,92 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — MeterPoller.h
+//  The polling loop for one Protek 506, without wxWidgets.
+//
+//  Run() sends the '\n' trigger on absolute PollScheduler
+//  deadlines and blocks on the port for the reply.  What becomes
+//  of the bytes (parsing, timestamps, raw capture, latency) is
+//  MeterExchange's, shared with AcquisitionEngine: each reading
+//  goes to the reading handler the moment its CR is seen, dated
+//  at the start of the reply on the wire.
+//
+//  ReaderThread wraps this for the GUI; the headless daemon
+//  (tools/protek506d) polls its meters with AcquisitionEngine.
+//  Run() belongs to one thread; Stop() and the counters may be
+//  called from any thread.  A stopped poller stays stopped.
+//
+//  Optionally every byte received, and every trigger sent, is
+//  recorded with its timestamp to a raw capture file that
+//  ReplaySource can feed through the pipeline again.
+// ============================================================
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "SerialPort.h"
+#include "PollScheduler.h"
+#include "MeterExchange.h"
+
+class MeterPoller
+{
+public:
+    // Called on the polling thread with the timestamps filled in.
+    using ReadingHandler = MeterExchange::ReadingHandler;
+
+    MeterPoller();
+
+    MeterPoller(const MeterPoller&) = delete;
+    MeterPoller& operator=(const MeterPoller&) = delete;
+
+    // Set before Run(); not synchronised.
+    void SetReadingHandler(ReadingHandler fn) { m_exchange.SetReadingHandler(std::move(fn)); }
+
+    // Record the Reply and Receive stages into 'stats' (may be null;
+    // must outlive Run()).  Set before Run().
+    void SetLatencyStats(LatencyStats* stats) { m_exchange.SetLatencyStats(stats); }
+
+    // Open 'device' at the Protek's 1200 baud 7N2 and anchor the
+    // readings' steady clock to the wall clock.  False with
+    // LastError() set if it cannot be opened.
+    bool Open(const std::string& device);
+
+    // Record the port's traffic to 'path' (appended; see RawCapture.h)
+    // during Run().  Call before Run(); false with LastError() set if
+    // the file cannot be opened.  A later write error ends the capture
+    // but not the polling, and sets CaptureFailed().
+    bool StartCapture(const std::string& path);
+
+    // Poll every pollDelayMs until Stop().  Closes the port on return.
+    // Returns true when stopped, false on a timer or serial error
+    // (LastError() says which).
+    bool Run(int pollDelayMs);
+
+    // Thread-safe: end Run() at the next deadline or reply timeout.
+    void Stop();
+    bool StopRequested() const { return m_scheduler.StopRequested(); }
+
+    // Poll deadlines skipped because a read/parse cycle overran the
+    // poll interval.
+    uint64_t MissedDeadlines() const { return m_scheduler.Missed(); }
+
+    // Replies discarded as garbled: unknown mode word, noise, a dropped
+    // CR running two lines together.
+    uint64_t GarbledFrames() const { return m_exchange.GarbledFrames(); }
+
+    // Raw capture progress (any thread)
+    uint64_t CaptureBytes()  const { return m_exchange.CaptureBytes(); }
+    bool     CaptureFailed() const { return m_exchange.CaptureFailed(); }
+
+    // The last error; a raw capture that stopped if nothing worse.
+    std::string LastError() const;
+
+private:
+    bool AwaitReading();
+    void SetError(const std::string& msg);
+
+    SerialPort          m_serial;
+    PollScheduler       m_scheduler;
+    MeterExchange       m_exchange;
+
+    mutable std::mutex  m_mutex;        // guards m_lastError
+    std::string         m_lastError;
+};
@@ -0,0 +1,159 @@
+// ============================================================
+//  Protek506Logger — PollScheduler.cpp
+// ============================================================
+#include "PollScheduler.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+// ========================= LINUX ================================
+
+// The wake eventfd is created here, before the scheduler can be shared,
+// so Stop() on another thread never races Start() for m_wakeFd.  If it
+// cannot be created, Start() fails.
+PollScheduler::PollScheduler()
+    : m_stop(false), m_missed(0), m_ticks(0)
+    , m_wakeFd(eventfd(0, EFD_CLOEXEC))
+{
+}
+
+PollScheduler::~PollScheduler()
+{
+    if (m_timerFd >= 0) ::close(m_timerFd);
+    if (m_wakeFd  >= 0) ::close(m_wakeFd);
+}
+
+bool PollScheduler::Start(int periodMs)
+{
+    if (periodMs < 1) periodMs = 1;
+    m_first = true;
+    m_missed.store(0);
+    m_ticks.store(0);
+
+    if (m_timerFd < 0)
+        m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (m_timerFd < 0 || m_wakeFd < 0)
+        return false;
+
+    // A periodic timerfd keeps its own absolute phase: expirations are
+    // start + k * period regardless of when we get round to reading it.
+    struct itimerspec its = {};
+    its.it_interval.tv_sec  = periodMs / 1000;
+    its.it_interval.tv_nsec = static_cast<long>(periodMs % 1000) * 1000000L;
+    its.it_value            = its.it_interval;
+    return timerfd_settime(m_timerFd, 0, &its, nullptr) == 0;
+}
+
+bool PollScheduler::WaitNext()
+{
+    if (m_stop.load()) return false;
+    if (m_first)
+    {
+        m_first = false;
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    struct pollfd fds[2];
+    fds[0].fd = m_timerFd; fds[0].events = POLLIN; fds[0].revents = 0;
+    fds[1].fd = m_wakeFd;  fds[1].events = POLLIN; fds[1].revents = 0;
+
+    for (;;)
+    {
+        int n = ::poll(fds, 2, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (fds[1].revents || m_stop.load())
+            return false;
+        if (fds[0].revents)
+            break;
+    }
+
+    uint64_t expirations = 0;
+    if (::read(m_timerFd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        expirations = 1;
+
+    // More than one expiry since the last read means the previous cycle
+    // ran past at least one deadline; those slots are skipped, not queued.
+    if (expirations > 1)
+        m_missed.fetch_add(expirations - 1, std::memory_order_relaxed);
+    m_ticks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PollScheduler::Stop()
+{
+    m_stop.store(true);
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t n = ::write(m_wakeFd, &one, sizeof(one));
+        (void)n;
+    }
+}
+
+#else
+// ========================= macOS / Windows ======================
+
+PollScheduler::PollScheduler() : m_stop(false), m_missed(0), m_ticks(0) {}
+PollScheduler::~PollScheduler() {}
+
+bool PollScheduler::Start(int periodMs)
+{
+    if (periodMs < 1) periodMs = 1;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_first    = true;
+    m_missed.store(0);
+    m_ticks.store(0);
+    m_period   = std::chrono::milliseconds(periodMs);
+    m_deadline = Clock::now();
+    return true;
+}
+
+bool PollScheduler::WaitNext()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_stop.load()) return false;
+    if (m_first)
+    {
+        m_first = false;
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Next absolute slot; if the last cycle overran, skip ahead to the
+    // first slot still in the future and count the ones we jumped over.
+    m_deadline += m_period;
+    Clock::time_point now = Clock::now();
+    if (now > m_deadline)
+    {
+        auto behind = (now - m_deadline) / m_period;
+        m_missed.fetch_add(static_cast<uint64_t>(behind), std::memory_order_relaxed);
+        m_deadline += behind * m_period;
+    }
+
+    if (m_cv.wait_until(lock, m_deadline, [this] { return m_stop.load(); }))
+        return false;
+    m_ticks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PollScheduler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true);
+    }
+    m_cv.notify_all();
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — PollScheduler.h
+//  Fixed-rate trigger clock for the polling loop.
+//
+//  Deadlines are absolute (start + k * period), so the time
+//  spent writing the trigger, waiting for the reply and parsing
+//  it does not stretch the sample period: "200 ms" is 5 Hz.
+//  A cycle that overruns one or more deadlines is counted in
+//  Missed() and the schedule resumes at the next future slot.
+//
+//  Linux  : periodic timerfd (CLOCK_MONOTONIC) plus an eventfd
+//           that Stop() signals, waited on together with poll().
+//  Others : condition_variable::wait_until on steady_clock.
+//
+//  Stop() may be called from any thread and wakes WaitNext()
+//  immediately; everything else belongs to the polling thread.
+// ============================================================
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+class PollScheduler
+{
+public:
+    PollScheduler();
+    ~PollScheduler();
+
+    PollScheduler(const PollScheduler&) = delete;
+    PollScheduler& operator=(const PollScheduler&) = delete;
+
+    // Begin a schedule whose first deadline is now.  Returns false if
+    // the platform timer could not be created.
+    bool Start(int periodMs);
+
+    // Block until the next deadline.  The first call returns at once.
+    // Returns false once Stop() has been called.
+    bool WaitNext();
+
+    // Thread-safe: end the schedule and wake a blocked WaitNext().
+    void Stop();
+
+    bool     StopRequested() const { return m_stop.load(); }
+    uint64_t Missed() const        { return m_missed.load(std::memory_order_relaxed); }
+    uint64_t Ticks() const         { return m_ticks.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool>     m_stop;
+    std::atomic<uint64_t> m_missed;
+    std::atomic<uint64_t> m_ticks;
+    bool                  m_first = true;
+
+#ifdef __linux__
+    int       m_timerFd = -1;       // polling thread only
+    const int m_wakeFd;             // set once in the constructor; Stop() writes it
+#else
+    using Clock = std::chrono::steady_clock;
+    Clock::duration         m_period{};
+    Clock::time_point       m_deadline{};
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+#endif
+};
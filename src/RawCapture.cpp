@@ -0,0 +1,182 @@
+// ============================================================
+//  Protek506Logger — RawCapture.cpp
+// ============================================================
+#include "RawCapture.h"
+#include <cstring>
+
+using namespace rawcap;
+
+// 64-bit file size (long is 32 bits on Windows)
+static uint64_t FileSize(FILE* fp)
+{
+#ifdef _WIN32
+    if (_fseeki64(fp, 0, SEEK_END) != 0) return 0;
+    int64_t size = _ftelli64(fp);
+    _fseeki64(fp, 0, SEEK_SET);
+#else
+    if (fseeko(fp, 0, SEEK_END) != 0) return 0;
+    off_t size = ftello(fp);
+    fseeko(fp, 0, SEEK_SET);
+#endif
+    return size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+// ----------------------------------------------------------------
+// Writer
+// ----------------------------------------------------------------
+RawCaptureWriter::RawCaptureWriter() {}
+RawCaptureWriter::~RawCaptureWriter() { Close(); }
+
+bool RawCaptureWriter::Open(const std::string& filePath, int64_t wallAnchorUs, int64_t monoAnchorUs)
+{
+    Close();
+    m_bytesWritten = 0;
+    m_lastError.clear();
+
+    m_fp = fopen(filePath.c_str(), "ab");
+    if (!m_fp)
+    {
+        m_lastError = "Cannot open file: " + filePath;
+        return false;
+    }
+    m_buffer.resize(kBufferSize);
+    setvbuf(m_fp, m_buffer.data(), _IOFBF, m_buffer.size());
+
+    // Session block: anchors this capture's monotonic timestamps to the
+    // wall clock, the same way the poller dates its readings.
+    Session s;
+    memcpy(s.magic, kMagic, sizeof(s.magic));
+    s.wallAnchorUs = wallAnchorUs;
+    s.monoAnchorUs = monoAnchorUs;
+
+    if (!Write(Type::Session, s.monoAnchorUs, reinterpret_cast<const uint8_t*>(&s), sizeof(s)) ||
+        fflush(m_fp) != 0)
+    {
+        if (m_fp) Fail("Write error on session header (disk full?)");
+        return false;
+    }
+    m_lastFlushUs = s.monoAnchorUs;
+    return true;
+}
+
+void RawCaptureWriter::Close()
+{
+    if (!m_fp) return;
+    if (fflush(m_fp) != 0 || ferror(m_fp))
+        m_lastError = "Write error (disk full or I/O error)";
+    fclose(m_fp);
+    m_fp = nullptr;
+}
+
+void RawCaptureWriter::Fail(const std::string& msg)
+{
+    m_lastError = msg;
+    fclose(m_fp);
+    m_fp = nullptr;
+}
+
+bool RawCaptureWriter::Put(const void* p, size_t len)
+{
+    if (len > 0 && fwrite(p, len, 1, m_fp) != 1)
+        return false;
+    m_bytesWritten += len;
+    return true;
+}
+
+bool RawCaptureWriter::Write(Type type, int64_t monoUs, const uint8_t* data, size_t len)
+{
+    if (!m_fp) return false;
+
+    // Longer spans than a block holds are split; the ring never hands
+    // out that much at once.
+    do
+    {
+        size_t n = len < 0xFFFF ? len : 0xFFFF;
+        Block b;
+        memset(&b, 0, sizeof(b));
+        b.monoUs = monoUs;
+        b.length = static_cast<uint16_t>(n);
+        b.type   = static_cast<uint8_t>(type);
+        if (!Put(&b, sizeof(b)) || !Put(data, n))
+        {
+            Fail("Write error (disk full or I/O error)");
+            return false;
+        }
+        data += n;
+        len  -= n;
+    } while (len > 0);
+
+    if (monoUs - m_lastFlushUs >= kFlushUs)
+    {
+        m_lastFlushUs = monoUs;
+        if (fflush(m_fp) != 0)
+        {
+            Fail("Write error (disk full or I/O error)");
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------
+// Reader
+// ----------------------------------------------------------------
+RawCaptureReader::RawCaptureReader() {}
+RawCaptureReader::~RawCaptureReader() { Close(); }
+
+bool RawCaptureReader::Open(const std::string& filePath)
+{
+    Close();
+    m_lastError.clear();
+
+    m_fp = fopen(filePath.c_str(), "rb");
+    if (!m_fp)
+    {
+        m_lastError = "Cannot open file: " + filePath;
+        return false;
+    }
+    m_buffer.resize(kBufferSize);
+    setvbuf(m_fp, m_buffer.data(), _IOFBF, m_buffer.size());
+    m_size = FileSize(m_fp);
+    m_payload.resize(0xFFFF);
+
+    // The first block must be a session with the right magic.
+    Block b;
+    if (fread(&b, sizeof(b), 1, m_fp) != 1 ||
+        b.type != static_cast<uint8_t>(Type::Session) || b.length != sizeof(Session) ||
+        fread(m_payload.data(), sizeof(Session), 1, m_fp) != 1 ||
+        memcmp(m_payload.data(), kMagic, sizeof(kMagic)) != 0)
+    {
+        Close();
+        m_lastError = "Not a raw capture file: " + filePath;
+        return false;
+    }
+    fseek(m_fp, 0, SEEK_SET);
+    return true;
+}
+
+void RawCaptureReader::Close()
+{
+    if (m_fp) fclose(m_fp);
+    m_fp        = nullptr;
+    m_pos       = 0;
+    m_size      = 0;
+    m_truncated = false;
+}
+
+bool RawCaptureReader::Next(Block& block, const uint8_t*& payload)
+{
+    if (!m_fp) return false;
+
+    size_t got = fread(&block, 1, sizeof(block), m_fp);
+    if (got == 0) return false;                         // clean end
+    if (got < sizeof(block) ||
+        fread(m_payload.data(), 1, block.length, m_fp) != block.length)
+    {
+        m_truncated = true;
+        return false;
+    }
+    m_pos  += sizeof(block) + block.length;
+    payload = m_payload.data();
+    return true;
+}
@@ -0,0 +1,132 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — RawCapture.h
+//  Timestamped capture of the raw serial bytes (*.p506raw),
+//  for re-running the pipeline on exactly what the meter sent
+//  (see ReplaySource).
+//
+//  The file is a sequence of blocks, little-endian, in the
+//  host's native layout like the binary session log:
+//
+//    [session] [rx|tx] [rx|tx] ... [session] [rx|tx] ...
+//
+//  Each block is a 16-byte header followed by 'length' bytes.
+//  A session block starts every capture (a file that is opened
+//  again gets another one appended); its payload carries a magic
+//  and anchors the blocks' monotonic timestamps to wall-clock
+//  time.  Rx blocks hold bytes as MeterPoller took them from the
+//  port, stamped when it did; tx blocks hold the triggers sent.
+//  A file cut short by a crash ends in a partial block, which
+//  the reader drops.
+// ============================================================
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace rawcap
+{
+
+static constexpr char kMagic[8] = { 'P', '5', '0', '6', 'R', 'A', 'W', '\x01' };
+
+enum class Type : uint8_t { Session = 1, Rx = 2, Tx = 3 };
+
+struct Block
+{
+    int64_t  monoUs;            // steady_clock µs, same clock as DmmSample::monoUs
+    uint16_t length;            // payload bytes that follow
+    uint8_t  type;              // Type
+    uint8_t  reserved[5];
+};
+
+struct Session
+{
+    char     magic[8];          // kMagic
+    int64_t  wallAnchorUs;      // system_clock at capture start, µs since epoch
+    int64_t  monoAnchorUs;      // steady_clock at the same instant, µs
+};
+
+static_assert(sizeof(Block)   == 16, "rawcap block header must be 16 bytes");
+static_assert(sizeof(Session) == 24, "rawcap session payload must be 24 bytes");
+
+} // namespace rawcap
+
+// ----------------------------------------------------------------
+// Writer: used on the polling thread, synchronously.  At 1200 baud
+// a day of capture is a few tens of MB, so blocks go through a
+// stdio buffer that is flushed about once a second.
+// ----------------------------------------------------------------
+class RawCaptureWriter
+{
+public:
+    RawCaptureWriter();
+    ~RawCaptureWriter();
+
+    RawCaptureWriter(const RawCaptureWriter&) = delete;
+    RawCaptureWriter& operator=(const RawCaptureWriter&) = delete;
+
+    // Append to 'filePath', starting with a session block that ties
+    // the steady clock to the wall clock (the poller's AcqClock anchor).
+    // False with LastError() set if it cannot be opened.
+    bool Open(const std::string& filePath, int64_t wallAnchorUs, int64_t monoAnchorUs);
+    void Close();
+    bool IsOpen() const { return m_fp != nullptr; }
+
+    // Append one block.  On a write error the file is closed and
+    // false returned with LastError() set; later calls do nothing.
+    bool Write(rawcap::Type type, int64_t monoUs, const uint8_t* data, size_t len);
+
+    uint64_t    BytesWritten() const { return m_bytesWritten; }
+    std::string LastError()    const { return m_lastError; }
+
+private:
+    static constexpr size_t  kBufferSize = 64 * 1024;
+    static constexpr int64_t kFlushUs    = 1000000;
+
+    bool Put(const void* p, size_t len);
+    void Fail(const std::string& msg);
+
+    FILE*             m_fp = nullptr;
+    std::vector<char> m_buffer;         // stdio buffer, lives as long as m_fp
+    int64_t           m_lastFlushUs  = 0;
+    uint64_t          m_bytesWritten = 0;
+    std::string       m_lastError;
+};
+
+// ----------------------------------------------------------------
+// Reader: blocks in file order, payloads in a reused buffer.
+// ----------------------------------------------------------------
+class RawCaptureReader
+{
+public:
+    RawCaptureReader();
+    ~RawCaptureReader();
+
+    RawCaptureReader(const RawCaptureReader&) = delete;
+    RawCaptureReader& operator=(const RawCaptureReader&) = delete;
+
+    // False with LastError() set if the file cannot be opened or does
+    // not start with a session block.
+    bool Open(const std::string& filePath);
+    void Close();
+
+    // Next block and its payload (valid until the next call).  Returns
+    // false at the end of the file, or at a partial block (Truncated()).
+    bool Next(rawcap::Block& block, const uint8_t*& payload);
+
+    uint64_t    Position()  const { return m_pos; }     // bytes consumed
+    uint64_t    Size()      const { return m_size; }
+    bool        Truncated() const { return m_truncated; }
+    std::string LastError() const { return m_lastError; }
+
+private:
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    FILE*                m_fp = nullptr;
+    std::vector<char>    m_buffer;
+    std::vector<uint8_t> m_payload;
+    uint64_t             m_pos  = 0;
+    uint64_t             m_size = 0;
+    bool                 m_truncated = false;
+    std::string          m_lastError;
+};
@@ -2,86 +2,34 @@
 //  Protek506Logger — ReaderThread.cpp
 // ============================================================
 #include "ReaderThread.h"
-#include <wx/datetime.h>
-#include <chrono>          // for high-resolution timestamping
 #include "Events.h"
 
 // === DEFINE THE EVENTS HERE (only once, in this file) ===
 wxDEFINE_EVENT(EVT_DMM_READING, wxCommandEvent);
 wxDEFINE_EVENT(EVT_DMM_ERROR,   wxCommandEvent);
-
-// ----------------------------------------------------------------
-// Pack reading into a pipe-delimited string.
-//
-// Time resolution: historically we logged only to the second via
-// FormatISOTime(), but users want tenths of a second when recording
-// fast-changing measurements.  `PackReading` now appends a decimal
-// digit derived from the millisecond counter.
-//
-// FIX (macOS + Linux column bug):
-//   The original code used FormatISOCombined() which produced ONE
-//   timestamp field ("2026-02-26T15:30:45"), but OnDmmReading()
-//   expects TWO separate fields (date and time) as parts[0] and
-//   parts[1].  This caused every subsequent field to be shifted
-//   right by one column on Linux (wrong display positions) and on
-//   macOS the sixth %s format specifier had no matching argument
-//   (undefined behaviour), producing a malformed string that failed
-//   the parts.GetCount() < 5 guard — so nothing was ever shown.
-//
-//   Fix: split the timestamp into date and time before packing, use
-//   exactly five fields, and drop rawLine (the receiver never used it).
-//
-// v1.4.0: Added rawLine as the 6th field so the receiver can log
-//   and display the verbatim ASCII line received from the meter.
-// ----------------------------------------------------------------
-static wxString PackReading(const DmmReading& r)
-{
-    wxDateTime now  = wxDateTime::Now();
-    wxString   date = now.FormatISODate();   // e.g. "2026-02-26"
-
-    // wxDateTime apparently only reports whole-second precision on some
-    // platforms (macOS build showed GetMillisecond()==0 every call), which
-    // produced a misleading ".0" digit for every timestamp.  Avoid
-    // reliance on its millisecond field and instead grab the current time
-    // via std::chrono for sub-second accuracy.
-    using namespace std::chrono;
-    system_clock::time_point tp = system_clock::now();
-    auto ms_total = duration_cast<milliseconds>(tp.time_since_epoch()).count();
-    int tenth = static_cast<int>((ms_total / 100) % 10);   // 0..9
-
-    // Convert tp to local calendar time for the HH:MM:SS portion.
-    std::time_t t = system_clock::to_time_t(tp);
-    std::tm tm_local;
-#if defined(_WIN32) || defined(__WINDOWS__)
-    localtime_s(&tm_local, &t);
-#else
-    localtime_r(&t, &tm_local);
-#endif
-    char buf[16]; // "HH:MM:SS" fits in 9 + null
-    std::strftime(buf, sizeof(buf), "%H:%M:%S", &tm_local);
-    wxString time = wxString::FromUTF8(buf) +
-                      wxString::Format(".%d", tenth);    // e.g. "15:30:45.3"
-
-    return wxString::Format("%s|%s|%s|%s|%s|%s",
-        date,
-        time,
-        wxString(r.modeName),
-        wxString(r.rawValue),
-        wxString::FromUTF8(r.units.c_str()),
-        wxString::FromUTF8(r.rawLine.c_str()));
-}
+wxDEFINE_EVENT(EVT_DMM_DONE,    wxCommandEvent);
+wxDEFINE_EVENT(EVT_LOG_ERROR,   wxCommandEvent);
 
 // ----------------------------------------------------------------
 // Constructor / Destructor / RequestStop
 // ----------------------------------------------------------------
 ReaderThread::ReaderThread(wxEvtHandler* sink,
+                           ReadingQueue* queue,
+                           AsyncLogWriter* log,
+                           SeriesStore* history,
+                           StatsEngine* stats,
+                           AlarmEngine* alarms,
                            const std::string& port,
                            int pollDelayMs)
     : wxThread(wxTHREAD_JOINABLE),
       m_sink(sink),
+      m_queue(queue),
+      m_log(log),
+      m_history(history),
+      m_stats(stats),
+      m_alarms(alarms),
       m_port(port),
-      m_pollDelayMs(pollDelayMs),
-      m_stop(false)
+      m_pollDelayMs(pollDelayMs)
 {
 }
 
@@ -89,7 +37,8 @@ ReaderThread::~ReaderThread() {}
 
 void ReaderThread::RequestStop()
 {
-    m_stop.store(true);
+    m_poller.Stop();
+    m_replay.Stop();
 }
 
 // ----------------------------------------------------------------
@@ -97,49 +46,75 @@ void ReaderThread::RequestStop()
 // ----------------------------------------------------------------
 wxThread::ExitCode ReaderThread::Entry()
 {
-    if (!m_serial.Open(m_port, 1200, 7, 2, 'N', 1000))
+    if (Replaying())
     {
-        PostError(wxString::Format("Cannot open port %s: %s",
-                                   m_port, m_serial.LastError()));
-        return (ExitCode)1;
-    }
-
-    while (!m_stop.load() && !TestDestroy())
-    {
-        m_serial.WriteByte('\n');               // Trigger every cycle
-
-        std::string line = m_serial.ReadLine('\r', 256);
-
-        if (!line.empty())
+        m_replay.SetReadingHandler([this](DmmSample& s) { PostReading(s); });
+        if (!m_replay.Open(m_replayPath))
         {
-            DmmReading r = m_parser.Parse(line);
-            if (r.valid)
-                PostReading(r);
+            PostError(wxString::FromUTF8(m_replay.LastError().c_str()));
+            return (ExitCode)1;
         }
-        else if (!m_serial.LastError().empty())
+        m_replay.Run(m_replaySpeed);
+        if (!m_replay.StopRequested() && m_sink)
         {
-            PostError(wxString::Format("Serial read error: %s",
-                                       m_serial.LastError()));
-            break;
+            auto* evt = new wxCommandEvent(EVT_DMM_DONE);
+            evt->SetInt(m_replay.Truncated() ? 1 : 0);
+            wxQueueEvent(m_sink, evt);
         }
-
-        for (int i = 0; i < m_pollDelayMs && !m_stop.load() && !TestDestroy(); i += 10)
-            wxThread::Sleep(10);
+        return (ExitCode)0;
     }
 
-    m_serial.Close();
+    m_poller.SetReadingHandler([this](DmmSample& s) { PostReading(s); });
+
+    if (!m_capturePath.empty() && !m_poller.StartCapture(m_capturePath))
+    {
+        PostError(wxString::FromUTF8(m_poller.LastError().c_str()));
+        return (ExitCode)1;
+    }
+    if (!m_poller.Open(m_port) || !m_poller.Run(m_pollDelayMs))
+    {
+        PostError(wxString::FromUTF8(m_poller.LastError().c_str()));
+        return (ExitCode)1;
+    }
     return (ExitCode)0;
 }
 
 // ----------------------------------------------------------------
 // Helpers
 // ----------------------------------------------------------------
-void ReaderThread::PostReading(const DmmReading& r)
+// v1.6.0: the reading travels as a DmmSample through the lock-free
+// ReadingQueue.  PackReading() and its date/time formatting are gone from
+// this thread; the GUI formats the timestamp only where it is displayed or
+// logged.  A full queue drops the reading (counted by the queue) rather
+// than blocking acquisition.  MeterPoller has already timestamped it.
+void ReaderThread::PostReading(DmmSample& s)
 {
-    if (!m_sink) return;
-    auto* evt = new wxCommandEvent(EVT_DMM_READING);
-    evt->SetString(PackReading(r));
-    wxQueueEvent(m_sink, evt);
+    // Alarm rules first: a limit crossing is decided while the CR is
+    // still fresh, ahead of the log, the history and the GUI hop.
+    if (m_alarms)
+        m_alarms->Evaluate(s);
+
+    // The CSV writer is fed from here, not from the GUI, so logging keeps
+    // going while the window is busy.  Push() is a no-op when not logging.
+    if (m_log)
+        m_log->Push(s);
+    if (m_history)
+        m_history->Append(0, s);
+    if (m_stats)
+        m_stats->Add(s);
+
+    if (m_latency)
+    {
+        s.queuedUs = LatencyStats::NowUs();
+        m_latency->Record(LatencyStage::FanOut, s.rxUs, s.queuedUs);
+    }
+
+    if (!m_queue || !m_queue->TryPush(s)) return;
+
+    // Only the push that finds the consumer idle posts a wakeup; further
+    // readings ride along with the batch it will drain.
+    if (m_sink && m_queue->Signal())
+        wxQueueEvent(m_sink, new wxCommandEvent(EVT_DMM_READING));
 }
 
 void ReaderThread::PostError(const wxString& msg)
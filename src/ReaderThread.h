@@ -3,36 +3,116 @@
 //  Protek506Logger — ReaderThread.h
 //  wxThread that polls the Protek 506 and posts events to
 //  the main frame whenever a valid reading arrives.
+//
+//  v1.6.0: the polling loop itself is MeterPoller (wx-free,
+//  shared with the headless daemon); this class runs it on a
+//  wxThread and fans each reading out to the GUI side.  The
+//  same thread can instead replay a raw capture (ReplaySource)
+//  through the same fan-out, and record one while polling.
 // ============================================================
 #include <wx/wx.h>
 #include <wx/thread.h>
-#include <atomic>
-#include "SerialPort.h"
 #include "DmmParser.h"
+#include "MeterPoller.h"
+#include "ReplaySource.h"
+#include "SpscQueue.h"
+#include "AsyncLogWriter.h"
+#include "SeriesStore.h"
+#include "StatsEngine.h"
+#include "AlarmEngine.h"
+#include "LatencyStats.h"
 #include "Events.h"
 
+// Readings handed from the reader thread to the GUI.  1024 slots is
+// several minutes of backlog at the fastest poll rate.
+using ReadingQueue = SpscQueue<DmmSample, 1024>;
+
 class ReaderThread : public wxThread
 {
 public:
+    // Readings are pushed into 'queue' (owned by the caller, which must
+    // outlive the thread); 'sink' receives an EVT_DMM_READING wakeup
+    // whenever the queue needs draining, and EVT_DMM_ERROR on failure.
+    // Each reading is also handed to 'log' (may be null), which writes
+    // it only while its file is open, appended to 'history' (may be
+    // null) as meter 0, and added to 'stats' (may be null).  'alarms'
+    // (may be null) evaluates its rules on each reading before any of
+    // that, as soon as the reading is parsed.
     ReaderThread(wxEvtHandler* sink,
+                 ReadingQueue* queue,
+                 AsyncLogWriter* log,
+                 SeriesStore* history,
+                 StatsEngine* stats,
+                 AlarmEngine* alarms,
                  const std::string& port,
                  int pollDelayMs = 200);
     virtual ~ReaderThread();
 
+    // Before Run(): record the port's raw traffic to 'path' while
+    // polling (see RawCapture.h).
+    void RecordRaw(const std::string& path) { m_capturePath = path; }
+
+    // Before Run(): replay the raw capture 'path' at 'speed' (0: as
+    // fast as possible) instead of polling the port.  The thread posts
+    // EVT_DMM_DONE when the capture has been played to the end.
+    void ReplayFrom(const std::string& path, double speed)
+    {
+        m_replayPath  = path;
+        m_replaySpeed = speed;
+    }
+    bool Replaying() const { return !m_replayPath.empty(); }
+
+    // Before Run(): time the Reply, Receive and FanOut stages into
+    // 'stats' (owned by the caller, must outlive the thread).
+    void SetLatencyStats(LatencyStats* stats)
+    {
+        m_latency = stats;
+        m_poller.SetLatencyStats(stats);
+    }
+
     // Signal the thread to stop.  Call this before Wait().
+    // Wakes a thread waiting for its next poll deadline immediately.
     void RequestStop();
 
+    // Poll deadlines skipped because a read/parse cycle overran the
+    // poll interval (safe to call from any thread).
+    uint64_t MissedDeadlines() const { return m_poller.MissedDeadlines(); }
+
+    // Replies discarded as garbled: unknown mode word, noise, a dropped
+    // CR running two lines together (safe to call from any thread).
+    uint64_t GarbledFrames() const
+    {
+        return Replaying() ? m_replay.GarbledFrames() : m_poller.GarbledFrames();
+    }
+
+    // Raw capture bytes written so far, and whether a write error ended
+    // the capture (any thread).
+    uint64_t CaptureBytes()  const { return m_poller.CaptureBytes(); }
+    bool     CaptureFailed() const { return m_poller.CaptureFailed(); }
+
+    // Replay progress: capture bytes read and total (any thread).
+    uint64_t ReplayPosition() const { return m_replay.BytesRead(); }
+    uint64_t ReplaySize()     const { return m_replay.Size(); }
+
 protected:
     virtual ExitCode Entry() override;
 
 private:
     wxEvtHandler*       m_sink;
+    ReadingQueue*       m_queue;
+    AsyncLogWriter*     m_log;
+    SeriesStore*        m_history;
+    StatsEngine*        m_stats;
+    AlarmEngine*        m_alarms;
     std::string         m_port;
     int                 m_pollDelayMs;
-    SerialPort          m_serial;
-    DmmParser           m_parser;
-    std::atomic<bool>   m_stop;   // fix #1: was plain bool — data race
+    MeterPoller         m_poller;
+    std::string         m_capturePath;      // empty: no raw capture
+    ReplaySource        m_replay;
+    std::string         m_replayPath;       // empty: poll the port
+    double              m_replaySpeed = 1.0;
+    LatencyStats*       m_latency     = nullptr;
 
-    void PostReading(const DmmReading& r);
+    void PostReading(DmmSample& s);
     void PostError(const wxString& msg);
 };
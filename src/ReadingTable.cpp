@@ -0,0 +1,178 @@
+// ============================================================
+//  Protek506Logger — ReadingTable.cpp
+// ============================================================
+#include "ReadingTable.h"
+#include <cstring>
+
+ReadingTable::ReadingTable(wxWindow* parent, wxWindowID id, size_t capacity)
+    : wxListCtrl(parent, id, wxDefaultPosition, wxDefaultSize,
+                 wxLC_REPORT | wxLC_VIRTUAL | wxLC_HRULES | wxLC_VRULES |
+                 wxBORDER_NONE),
+      m_capacity(capacity > 0 ? capacity : 1)
+{
+    InsertColumn(0, "#",       wxLIST_FORMAT_RIGHT,  50);
+    InsertColumn(1, "Date",    wxLIST_FORMAT_LEFT,  100);
+    InsertColumn(2, "Time",    wxLIST_FORMAT_LEFT,  115);
+    InsertColumn(3, "Mode",    wxLIST_FORMAT_LEFT,   70);
+    InsertColumn(4, "Reading", wxLIST_FORMAT_RIGHT, 110);
+    InsertColumn(5, "Units",   wxLIST_FORMAT_LEFT,   90);
+    InsertColumn(6, "Raw",     wxLIST_FORMAT_LEFT,  160);
+
+    UpdateColours();
+    Bind(wxEVT_SYS_COLOUR_CHANGED, &ReadingTable::OnSysColourChanged, this);
+}
+
+// ----------------------------------------------------------------
+// Dark-mode-safe alternating row colours from the system palette
+// ----------------------------------------------------------------
+void ReadingTable::UpdateColours()
+{
+    wxColour base   = wxSystemSettings::GetColour(wxSYS_COLOUR_LISTBOX);
+    wxColour text   = wxSystemSettings::GetColour(wxSYS_COLOUR_LISTBOXTEXT);
+    wxColour accent = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW);
+
+    auto blend = [](wxColour a, wxColour b, double t) -> wxColour {
+        return wxColour(
+            static_cast<unsigned char>(a.Red()   * (1-t) + b.Red()   * t),
+            static_cast<unsigned char>(a.Green() * (1-t) + b.Green() * t),
+            static_cast<unsigned char>(a.Blue()  * (1-t) + b.Blue()  * t));
+    };
+    m_attrStripe.SetBackgroundColour(blend(base, accent, 0.35));
+    m_attrStripe.SetTextColour(text);
+    m_attrPlain.SetBackgroundColour(base);
+    m_attrPlain.SetTextColour(text);
+}
+
+void ReadingTable::OnSysColourChanged(wxSysColourChangedEvent& evt)
+{
+    UpdateColours();
+    Refresh();
+    evt.Skip();
+}
+
+// ----------------------------------------------------------------
+// Ring
+// ----------------------------------------------------------------
+void ReadingTable::SetCapacity(size_t capacity)
+{
+    m_capacity = capacity > 0 ? capacity : 1;
+    Clear();
+}
+
+void ReadingTable::Clear()
+{
+    std::vector<Row>().swap(m_rows);    // give the memory back
+    m_oldest  = 0;
+    m_pending = false;
+    SetItemCount(0);
+    Refresh();
+}
+
+void ReadingTable::Append(long number, const DmmSample& s)
+{
+    Row r;
+    r.wallUs   = s.wallUs;
+    r.number   = static_cast<uint32_t>(number);
+    r.mode     = s.mode;
+    r.unit     = s.unit;
+    r.kind     = s.kind;
+    r.rawLen   = s.rawLen;
+    r.valueOff = s.valueOff;
+    r.valueLen = s.valueLen;
+    r.unitOff  = s.unitOff;
+    r.unitLen  = s.unitLen;
+    memcpy(r.raw, s.raw, sizeof(r.raw));
+
+    if (m_rows.size() < m_capacity)
+    {
+        m_rows.push_back(r);
+    }
+    else
+    {
+        m_rows[m_oldest] = r;
+        m_oldest = (m_oldest + 1) % m_capacity;
+    }
+    m_pending = true;
+}
+
+void ReadingTable::Flush()
+{
+    if (!m_pending) return;
+    m_pending = false;
+
+    long count = static_cast<long>(m_rows.size());
+    if (GetItemCount() != count)
+    {
+        SetItemCount(count);
+    }
+    else
+    {
+        // Full ring: every row moved up, so the visible page changed.
+        long top = GetTopItem();
+        long end = top + GetCountPerPage();
+        RefreshItems(top, end < count ? end : count - 1);
+    }
+    EnsureVisible(count - 1);
+}
+
+const ReadingTable::Row& ReadingTable::RowAt(long item) const
+{
+    size_t i = m_oldest + static_cast<size_t>(item);
+    return m_rows[i < m_rows.size() ? i : i - m_rows.size()];
+}
+
+// ----------------------------------------------------------------
+// Virtual callbacks: only visible cells are ever formatted
+// ----------------------------------------------------------------
+wxString ReadingTable::OnGetItemText(long item, long column) const
+{
+    if (item < 0 || static_cast<size_t>(item) >= m_rows.size())
+        return wxEmptyString;
+    const Row& r = RowAt(item);
+
+    switch (column)
+    {
+        case 0:
+            return wxString::Format("%lu", static_cast<unsigned long>(r.number));
+        case 1:
+        case 2:
+        {
+            char text[TimestampFormatter::kTimeMax];
+            size_t len = column == 1 ? m_timeFmt.Date(r.wallUs, text)
+                                     : m_timeFmt.Time(r.wallUs, text);
+            return wxString(text, len);
+        }
+        case 3:
+            return wxString(DmmModeName(r.mode));
+        case 4:
+        case 5:
+        {
+            // The text helpers take a sample; only these fields matter.
+            DmmSample s;
+            s.unit     = r.unit;
+            s.kind     = r.kind;
+            s.valueOff = r.valueOff;
+            s.valueLen = r.valueLen;
+            s.unitOff  = r.unitOff;
+            s.unitLen  = r.unitLen;
+            memcpy(s.raw, r.raw, sizeof(s.raw));
+            int len = 0;
+            const char* text = column == 4 ? DmmValueText(s, len)
+                                           : DmmUnitsText(s, len);
+            return wxString::FromUTF8(text, len);
+        }
+        case 6:
+            return wxString::FromUTF8(r.raw, r.rawLen);
+        default:
+            return wxEmptyString;
+    }
+}
+
+wxItemAttr* ReadingTable::OnGetItemAttr(long item) const
+{
+    // Stripe on the row number, so rows keep their colour as the full
+    // ring scrolls underneath them.
+    if (item < 0 || static_cast<size_t>(item) >= m_rows.size())
+        return nullptr;
+    return RowAt(item).number % 2 != 0 ? &m_attrStripe : &m_attrPlain;
+}
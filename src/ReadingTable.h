@@ -0,0 +1,77 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — ReadingTable.h
+//  Virtual-mode wxListCtrl for the Reading Log.
+//
+//  The control holds no items of its own: rows live in a
+//  fixed-capacity ring of compact records (64 bytes each) and
+//  OnGetItemText() formats a cell only when it is painted.  An
+//  append is a copy into the ring; once the ring is full the
+//  oldest row is overwritten, so keeping a million rows costs
+//  the same per reading as keeping a hundred.
+//
+//  Append() only stores; Flush() — once per drained batch —
+//  updates the item count, repaints the visible page and
+//  scrolls to the newest row.
+// ============================================================
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <cstdint>
+#include <vector>
+#include "DmmParser.h"
+#include "TimestampFormatter.h"
+
+class ReadingTable : public wxListCtrl
+{
+public:
+    static const size_t kDefaultCapacity = 1000000;
+
+    ReadingTable(wxWindow* parent, wxWindowID id,
+                 size_t capacity = kDefaultCapacity);
+
+    // Changing the capacity clears the table.
+    void   SetCapacity(size_t capacity);
+    size_t Capacity() const { return m_capacity; }
+
+    // 'number' is the value shown in the "#" column.
+    void Append(long number, const DmmSample& s);
+    void Flush();
+    void Clear();
+
+protected:
+    wxString    OnGetItemText(long item, long column) const override;
+    wxItemAttr* OnGetItemAttr(long item) const override;
+
+private:
+    struct Row
+    {
+        int64_t      wallUs;
+        uint32_t     number;
+        DmmMode      mode;
+        DmmUnit      unit;
+        DmmValueKind kind;
+        uint8_t      rawLen;
+        uint8_t      valueOff;
+        uint8_t      valueLen;
+        uint8_t      unitOff;
+        uint8_t      unitLen;
+        char         raw[DmmSample::kRawMax];
+    };
+    static_assert(sizeof(Row) <= 64, "keep ReadingTable rows compact");
+
+    const Row& RowAt(long item) const;
+    void UpdateColours();
+    void OnSysColourChanged(wxSysColourChangedEvent& evt);
+
+    std::vector<Row> m_rows;              // grows to m_capacity, then wraps
+    size_t           m_capacity;
+    size_t           m_oldest   = 0;      // ring index of item 0 once full
+    bool             m_pending  = false;  // appended since the last Flush()
+
+    // Computed once (and again on a theme change), not per row
+    mutable wxItemAttr m_attrStripe;
+    mutable wxItemAttr m_attrPlain;
+
+    // Visible rows are mostly in the same second: date / HH:MM:SS cached
+    mutable TimestampFormatter m_timeFmt;
+};
@@ -0,0 +1,148 @@
+// ============================================================
+//  Protek506Logger — ReplaySource.cpp
+// ============================================================
+#include "ReplaySource.h"
+#include <chrono>
+#include <cstring>
+
+ReplaySource::ReplaySource() {}
+
+std::string ReplaySource::LastError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+void ReplaySource::SetError(const std::string& msg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastError = msg;
+}
+
+bool ReplaySource::Open(const std::string& path)
+{
+    if (!m_reader.Open(path))
+    {
+        SetError(m_reader.LastError());
+        return false;
+    }
+    m_size.store(m_reader.Size(), std::memory_order_relaxed);
+    m_bytesRead.store(0, std::memory_order_relaxed);
+    m_readings.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void ReplaySource::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_stop = true;
+    }
+    m_waitCv.notify_all();
+}
+
+// Sleep until the steady clock reaches realUs; false if stopped.
+bool ReplaySource::WaitUntil(int64_t realUs)
+{
+    using namespace std::chrono;
+    steady_clock::time_point until{microseconds(realUs)};
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_waitCv.wait_until(lock, until, [this] { return m_stop.load(); });
+    return !m_stop;
+}
+
+// ----------------------------------------------------------------
+// Replay loop
+// ----------------------------------------------------------------
+void ReplaySource::Run(double speed)
+{
+    const int64_t runStartUs = AcqClock::NowUs();
+
+    int64_t monoOffsetUs = 0;       // recorded mono → this run's timeline
+    int64_t lastMonoUs   = -1;      // last rx block, on this run's timeline
+    int64_t paceRealUs   = 0;       // pacing origin: real time ...
+    int64_t paceMonoUs   = 0;       // ... and timeline position
+
+    int64_t feedUs = 0;             // steady clock when the block was fed
+    auto post = [this, &feedUs](DmmSample& s)
+    {
+        // Recorded times for the reading itself; the real time for the
+        // CR, which the latency stages and alarm latency start from.
+        m_clock.Stamp(s, m_stream.CrOffset());
+        s.rxUs = feedUs;
+        m_readings.fetch_add(1, std::memory_order_relaxed);
+        if (m_onReading)
+            m_onReading(s);
+    };
+
+    rawcap::Block   b;
+    const uint8_t*  data = nullptr;
+    bool            haveSession = false;
+    while (!m_stop && m_reader.Next(b, data))
+    {
+        m_bytesRead.store(m_reader.Position(), std::memory_order_relaxed);
+
+        if (b.type == static_cast<uint8_t>(rawcap::Type::Session))
+        {
+            if (b.length != sizeof(rawcap::Session)) continue;
+            rawcap::Session s;
+            memcpy(&s, data, sizeof(s));
+
+            // A new capture: its own clock anchors.  The timeline goes on
+            // from the previous capture by the wall-clock gap between
+            // them (never backwards), and pacing restarts there.
+            int64_t startUs = runStartUs;
+            if (haveSession && lastMonoUs >= 0)
+            {
+                int64_t prevWall = m_clock.WallUs(lastMonoUs);
+                int64_t gap      = s.wallAnchorUs - prevWall;
+                startUs = lastMonoUs + (gap > 0 ? gap : 0);
+            }
+            monoOffsetUs = startUs - s.monoAnchorUs;
+            m_clock.Anchor(s.wallAnchorUs, startUs);
+            paceRealUs   = AcqClock::NowUs();
+            paceMonoUs   = startUs;
+            haveSession  = true;
+
+            // Like reopening the port: a reply cut off there is lost.
+            if (m_stream.InFrame()) m_stream.Reset();
+            m_clock.Reset();
+            continue;
+        }
+        if (!haveSession)
+            continue;
+        if (b.type == static_cast<uint8_t>(rawcap::Type::Tx))
+        {
+            m_clock.Trigger(b.monoUs + monoOffsetUs);
+            continue;
+        }
+        if (b.type != static_cast<uint8_t>(rawcap::Type::Rx))
+            continue;
+
+        int64_t blockUs = b.monoUs + monoOffsetUs;
+        if (blockUs < lastMonoUs) blockUs = lastMonoUs;     // clock stepped; keep order
+
+        // The live poller drops a half-received reply after its read
+        // timeout; do the same on a gap that long.
+        if (lastMonoUs >= 0 && blockUs - lastMonoUs >= kReplyTimeoutUs && m_stream.InFrame())
+        {
+            m_stream.Reset();
+            m_clock.Reset();
+        }
+        lastMonoUs = blockUs;
+
+        if (speed > 0)
+        {
+            int64_t due = paceRealUs + static_cast<int64_t>((blockUs - paceMonoUs) / speed);
+            if (due > AcqClock::NowUs() && !WaitUntil(due))
+                break;
+        }
+        m_clock.Received(blockUs, b.length);
+        feedUs = AcqClock::NowUs();
+        m_stream.Feed(data, b.length, post);
+    }
+
+    m_bytesRead.store(m_reader.Position(), std::memory_order_relaxed);
+    m_truncated.store(m_reader.Truncated(), std::memory_order_relaxed);
+    m_reader.Close();
+}
@@ -0,0 +1,102 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — ReplaySource.h
+//  Feeds a raw capture (*.p506raw, see RawCapture.h) back
+//  through the stream parser as if the meter were sending it.
+//
+//  Readings reach the reading handler exactly as MeterPoller's
+//  do, so the log, history, stats, alarms and the display see
+//  the same samples they saw live.  Speed is real time (1),
+//  N times faster, or as fast as the pipeline takes them (0).
+//
+//  Timestamps: the recorded trigger and receive times go
+//  through an AcqClock anchored by the capture's session block,
+//  so wallUs is the original wall-clock time and a re-written
+//  log matches the first one.  monoUs keeps the
+//  recorded spacing but is rebased to start at Run(), so it
+//  stays in step with the steady clock of this run; at speeds
+//  above 1 it runs ahead of it.  rxUs is the exception: it is
+//  the steady-clock time the bytes were fed to the parser, so
+//  the latency stages measured from the CR (fan-out, log
+//  write, display, alarm) time this run, not the recording.
+//  The gap between two captures
+//  appended to one file is kept in the timestamps but not
+//  waited out.
+//
+//  Run() belongs to one thread; Stop() and the counters may be
+//  called from any thread.
+// ============================================================
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "DmmParser.h"
+#include "DmmStreamParser.h"
+#include "RawCapture.h"
+#include "AcqClock.h"
+
+class ReplaySource
+{
+public:
+    using ReadingHandler = std::function<void(DmmSample& s)>;
+
+    ReplaySource();
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    // Set before Run(); not synchronised.
+    void SetReadingHandler(ReadingHandler fn) { m_onReading = std::move(fn); }
+
+    // False with LastError() set if 'path' is not a raw capture.
+    bool Open(const std::string& path);
+
+    // Replay the whole capture at 'speed' (0: no pacing), until the end
+    // of the file or Stop().  Closes the file on return.
+    void Run(double speed);
+
+    // Thread-safe: end Run() promptly, also during a paced wait.
+    void Stop();
+    bool StopRequested() const { return m_stop.load(); }
+
+    // Replies the stream parser discarded, as MeterPoller::GarbledFrames()
+    uint64_t GarbledFrames() const { return m_stream.Garbled(); }
+
+    // Progress, in readings and capture bytes (any thread)
+    uint64_t Readings()      const { return m_readings.load(std::memory_order_relaxed); }
+    uint64_t BytesRead()     const { return m_bytesRead.load(std::memory_order_relaxed); }
+    uint64_t Size()          const { return m_size.load(std::memory_order_relaxed); }
+
+    // After Run(): the capture ended in a partial block (cut short by a
+    // crash, or still being written); everything before it was replayed.
+    bool     Truncated()     const { return m_truncated.load(std::memory_order_relaxed); }
+
+    std::string LastError() const;
+
+private:
+    // Same as the live port's read timeout: a gap this long between
+    // received bytes drops a half-received reply there too.
+    static constexpr int64_t kReplyTimeoutUs = 1000000;
+
+    bool WaitUntil(int64_t realUs);
+    void SetError(const std::string& msg);
+
+    RawCaptureReader      m_reader;
+    DmmStreamParser       m_stream;
+    AcqClock              m_clock;
+    ReadingHandler        m_onReading;
+
+    std::atomic<bool>     m_stop{false};
+    std::mutex            m_waitMutex;
+    std::condition_variable m_waitCv;
+
+    std::atomic<uint64_t> m_readings{0};
+    std::atomic<uint64_t> m_bytesRead{0};
+    std::atomic<uint64_t> m_size{0};
+    std::atomic<bool>     m_truncated{false};
+
+    mutable std::mutex    m_mutex;          // guards m_lastError
+    std::string           m_lastError;
+};
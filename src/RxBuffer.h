@@ -0,0 +1,126 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — RxBuffer.h
+//  Fixed-capacity receive ring owned by each SerialPort.
+//
+//  The port drains everything the driver has buffered into the
+//  ring in one read() / ReadFile() call, and complete lines are
+//  then handed out from memory.  Bytes that follow a terminator
+//  stay in the ring for the next call.
+//
+//  Head and tail are free-running counters; they are masked only
+//  when indexing, so Size() is always tail - head.
+// ============================================================
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class RxBuffer
+{
+public:
+    static constexpr size_t kCapacity = 1024;   // must be a power of two
+
+    size_t Size()  const { return m_tail - m_head; }
+    size_t Free()  const { return kCapacity - Size(); }
+    bool   Empty() const { return m_head == m_tail; }
+    void   Clear()       { m_head = m_tail = 0; }
+
+    // Contiguous free span for the next block read.  len is set to 0
+    // when the ring is full.  Call Commit() with the bytes received.
+    uint8_t* WritePtr(size_t& len)
+    {
+        size_t pos = m_tail & kMask;
+        len = Free();
+        if (len > kCapacity - pos) len = kCapacity - pos;
+        return m_data + pos;
+    }
+    void Commit(size_t n) { m_tail += n; }
+
+    // Contiguous readable span starting at the head.
+    const uint8_t* ReadPtr(size_t& len) const
+    {
+        size_t pos = m_head & kMask;
+        len = Size();
+        if (len > kCapacity - pos) len = kCapacity - pos;
+        return m_data + pos;
+    }
+    void Consume(size_t n) { m_head += n; }
+
+    // Copy up to maxLen buffered bytes into buf and consume them.
+    size_t Pop(uint8_t* buf, size_t maxLen)
+    {
+        size_t done = 0;
+        while (done < maxLen && !Empty())
+        {
+            size_t len;
+            const uint8_t* p = ReadPtr(len);
+            if (len > maxLen - done) len = maxLen - done;
+            memcpy(buf + done, p, len);
+            Consume(len);
+            done += len;
+        }
+        return done;
+    }
+
+    // Append the next line (terminator stripped) to 'line' and consume
+    // it, terminator included.  A run of maxBytes without a terminator
+    // is also returned as a line, matching the old byte-wise loop.
+    // Returns false, leaving the ring untouched, if neither is buffered.
+    bool PopLine(uint8_t terminator, size_t maxBytes, std::string& line)
+    {
+        size_t avail = Size() < maxBytes ? Size() : maxBytes;
+        size_t scanned = 0;
+        while (scanned < avail)
+        {
+            size_t pos = (m_head + scanned) & kMask;
+            size_t len = avail - scanned;
+            if (len > kCapacity - pos) len = kCapacity - pos;
+            const void* hit = memchr(m_data + pos, terminator, len);
+            if (hit)
+            {
+                size_t n = scanned +
+                    static_cast<size_t>(static_cast<const uint8_t*>(hit) -
+                                        (m_data + pos));
+                Append(n, line);
+                Consume(1);                  // drop the terminator
+                return true;
+            }
+            scanned += len;
+        }
+        if (avail == maxBytes && maxBytes > 0)
+        {
+            Append(maxBytes, line);
+            return true;
+        }
+        return false;
+    }
+
+    // Append up to maxBytes buffered bytes to 'line' without looking for
+    // a terminator.  Used to hand back a partial line on timeout.
+    void PopPartial(size_t maxBytes, std::string& line)
+    {
+        Append(Size() < maxBytes ? Size() : maxBytes, line);
+    }
+
+private:
+    static constexpr size_t kMask = kCapacity - 1;
+    static_assert((kCapacity & kMask) == 0, "kCapacity must be a power of two");
+
+    void Append(size_t n, std::string& line)
+    {
+        while (n > 0)
+        {
+            size_t len;
+            const uint8_t* p = ReadPtr(len);
+            if (len > n) len = n;
+            line.append(reinterpret_cast<const char*>(p), len);
+            Consume(len);
+            n -= len;
+        }
+    }
+
+    uint8_t m_data[kCapacity];
+    size_t  m_head = 0;
+    size_t  m_tail = 0;
+};
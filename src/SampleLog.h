@@ -0,0 +1,46 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — SampleLog.h
+//  Common interface of the session-log backends (CsvLogger,
+//  BinLogger), so AsyncLogWriter can drive either one.
+//
+//  Both buffer their output and flush it according to a
+//  LogFlushPolicy; Tick() applies the time-based parts and
+//  should be called periodically.  A failed write closes the
+//  file: WriteOk() turns false and LastError() says why.
+// ============================================================
+#include <cstdint>
+#include <string>
+#include "DmmParser.h"
+
+struct LogFlushPolicy
+{
+    int everyRows = 1;      // flush after this many rows (1 = every row, 0 = no row limit)
+    int everyMs   = 0;      // flush rows older than this (0 = no time limit)
+    int syncMs    = 0;      // fdatasync at most this often (0 = never)
+};
+
+class SampleLog
+{
+public:
+    virtual ~SampleLog() {}
+
+    virtual bool Open(const std::string& filePath) = 0;
+    virtual void Close() = 0;
+    virtual bool IsOpen() const = 0;
+
+    virtual void SetFlushPolicy(const LogFlushPolicy& policy) = 0;
+
+    virtual void Write(const DmmSample& s) = 0;
+    virtual void Tick() = 0;
+    virtual bool Flush() = 0;
+
+    virtual bool        WriteOk()   const = 0;
+    virtual std::string LastError() const = 0;
+
+    // Counters since Open()
+    virtual long     RowCount()     const = 0;
+    virtual uint64_t BytesWritten() const = 0;
+    virtual uint64_t FlushCount()   const = 0;
+    virtual int64_t  WorstFlushUs() const = 0;   // flush or sync
+};
@@ -132,6 +132,7 @@ void SerialPort::Close()
     if (m_open && m_handle != INVALID_HANDLE_VALUE)
         CloseHandle(m_handle);
     m_handle = INVALID_HANDLE_VALUE;
+    m_rx.Clear();
     m_open = false;
 }
 
@@ -154,33 +155,62 @@ int SerialPort::WriteByte(uint8_t b)
     return Write(&b, 1);
 }
 
-int SerialPort::Read(uint8_t* buf, int maxLen)
+// The COMMTIMEOUTS set in Open() (MAXDWORD / MAXDWORD / timeoutMs) make
+// ReadFile return as soon as at least one byte is available, with as many
+// bytes as the driver holds, or after timeoutMs with nothing.  That is the
+// same wait-then-drain behaviour as select() + read() on POSIX.
+int SerialPort::FillRx()
 {
     if (!m_open) return -1;
+    size_t room = 0;
+    uint8_t* p = m_rx.WritePtr(room);
+    if (room == 0) return 0;
+
     DWORD got = 0;
-    if (!ReadFile(m_handle, buf, static_cast<DWORD>(maxLen), &got, nullptr))
+    if (!ReadFile(m_handle, p, static_cast<DWORD>(room), &got, nullptr))
     {
         SetError("ReadFile failed");
         return -1;
     }
+    m_rx.Commit(got);
     return static_cast<int>(got);
 }
 
-std::string SerialPort::ReadLine(uint8_t terminator, int maxBytes)
+int SerialPort::ReadAvailable()
 {
-    m_lastError.clear();
-    std::string line;
-    line.reserve(32);
-    uint8_t ch;
-    while (static_cast<int>(line.size()) < maxBytes)
+    if (!m_open) return -1;
+
+    // ReadFile would block for the port timeout when the queue is empty,
+    // so ask the driver how much is waiting and read exactly that.
+    COMSTAT stat = {};
+    DWORD   errs = 0;
+    if (!ClearCommError(m_handle, &errs, &stat))
     {
-        int n = Read(&ch, 1);
-        if (n < 0) return line;
-        if (n == 0) break;
-        if (ch == terminator) break;
-        line += static_cast<char>(ch);
+        SetError("ClearCommError failed");
+        return -1;
     }
-    return line;
+
+    int   total   = 0;
+    DWORD pending = stat.cbInQue;
+    while (pending > 0)
+    {
+        size_t room = 0;
+        uint8_t* p = m_rx.WritePtr(room);
+        if (room == 0) break;
+
+        DWORD want = (pending < room) ? pending : static_cast<DWORD>(room);
+        DWORD got  = 0;
+        if (!ReadFile(m_handle, p, want, &got, nullptr))
+        {
+            SetError("ReadFile failed");
+            return total > 0 ? total : -1;
+        }
+        if (got == 0) break;
+        m_rx.Commit(got);
+        total   += static_cast<int>(got);
+        pending -= got;
+    }
+    return total;
 }
 
 void SerialPort::SetError(const std::string& msg)
@@ -332,7 +362,7 @@ bool SerialPort::Open(const std::string& device, int baudRate,
                       int dataBits, int stopBits, char parity, int timeoutMs)
 {
     Close();
-    m_timeoutMs = timeoutMs;    // fix #7: store for use in ReadLine()
+    m_timeoutMs = timeoutMs;    // fix #7: store for use in FillRx()
 
     m_fd = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
     if (m_fd < 0)
@@ -341,7 +371,7 @@ bool SerialPort::Open(const std::string& device, int baudRate,
         return false;
     }
 
-    // Switch to blocking mode; timing is handled by select() in ReadLine
+    // Switch to blocking mode; timing is handled by select() in FillRx
     int flags = fcntl(m_fd, F_GETFL, 0);
     fcntl(m_fd, F_SETFL, flags & ~O_NONBLOCK);
 
@@ -400,7 +430,7 @@ bool SerialPort::Open(const std::string& device, int baudRate,
     tty.c_oflag &= ~OPOST;
 
     // fix #7: VMIN=0 VTIME=0 → fully non-blocking reads.
-    // All timeout logic is handled by select() in ReadLine() so that:
+    // All timeout logic is handled by select() in FillRx() so that:
     //  (a) the full inter-character gap at 1200 baud is tolerated, and
     //  (b) the overall line timeout still applies if the meter is silent.
     tty.c_cc[VMIN]  = 0;
@@ -424,18 +454,17 @@ void SerialPort::Close()
         ::close(m_fd);
         m_fd = -1;
     }
+    m_rx.Clear();
     m_open = false;
 }
 
-std::string SerialPort::ReadLine(uint8_t terminator, int maxBytes)
+// Wait for the first byte with select() so the port timeout still applies
+// while the meter is silent, then take everything the tty has queued.
+int SerialPort::FillRx()
 {
-    m_lastError.clear();
-
-    std::string line;
-    line.reserve(32);
+    if (!m_open || m_fd < 0) return -1;
 
-    uint8_t ch;
-    while (static_cast<int>(line.size()) < maxBytes)
+    for (;;)
     {
         fd_set rdset;
         FD_ZERO(&rdset);
@@ -450,25 +479,45 @@ std::string SerialPort::ReadLine(uint8_t terminator, int maxBytes)
         {
             if (errno == EINTR) continue;
             SetError(std::string("select() failed: ") + strerror(errno));
-            return line;
+            return -1;
         }
         if (ready == 0)
-        {
-            return line;  // timeout
-        }
+            return 0;   // timeout
+        break;
+    }
+    return ReadAvailable();
+}
 
-        ssize_t n = ::read(m_fd, &ch, 1);
+// Drain the tty queue in as few read() calls as the ring's wrap point
+// allows (one, usually two at most).  VMIN=0 / VTIME=0 makes read()
+// return at once when nothing is left.
+int SerialPort::ReadAvailable()
+{
+    if (!m_open || m_fd < 0) return -1;
+
+    int total = 0;
+    for (;;)
+    {
+        size_t room = 0;
+        uint8_t* p = m_rx.WritePtr(room);
+        if (room == 0) break;
+
+        ssize_t n = ::read(m_fd, p, room);
         if (n < 0)
         {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
             SetError(std::string("read() failed: ") + strerror(errno));
-            return line;
+            return total > 0 ? total : -1;
         }
-        if (n == 0) break;
+        m_rx.Commit(static_cast<size_t>(n));
+        total += static_cast<int>(n);
 
-        if (ch == terminator) break;
-        line += static_cast<char>(ch);
+        // A short read means the driver queue is empty; a full span may
+        // just have hit the wrap point, so try once more.
+        if (static_cast<size_t>(n) < room) break;
     }
-    return line;
+    return total;
 }
 
 int SerialPort::Write(const uint8_t* data, int len)
@@ -495,4 +544,52 @@ void SerialPort::SetError(const std::string& msg)
     m_lastError = msg;
 }
 
-#endif // _WIN32
\ No newline at end of file
+#endif // _WIN32
+
+// ================================================================
+// Buffered reads (all platforms)
+// ================================================================
+int SerialPort::Read(uint8_t* buf, int maxLen)
+{
+    if (!m_open) return -1;
+    if (maxLen <= 0) return 0;
+    if (m_rx.Empty())
+    {
+        int n = FillRx();
+        if (n <= 0) return n;
+    }
+    return static_cast<int>(m_rx.Pop(buf, static_cast<size_t>(maxLen)));
+}
+
+bool SerialPort::NextLine(std::string& line, uint8_t terminator, int maxBytes)
+{
+    line.clear();
+    size_t limit = maxBytes > 0 ? static_cast<size_t>(maxBytes) : 0;
+    if (limit > RxBuffer::kCapacity) limit = RxBuffer::kCapacity;
+    return m_rx.PopLine(terminator, limit, line);
+}
+
+std::string SerialPort::ReadLine(uint8_t terminator, int maxBytes)
+{
+    m_lastError.clear();
+
+    std::string line;
+    line.reserve(32);
+
+    // A line can never be longer than the ring itself.
+    size_t limit = maxBytes > 0 ? static_cast<size_t>(maxBytes) : 0;
+    if (limit > RxBuffer::kCapacity) limit = RxBuffer::kCapacity;
+
+    while (!m_rx.PopLine(terminator, limit, line))
+    {
+        // Same contract as the old byte-wise loop: a timeout, EOF or error
+        // hands back whatever partial line has arrived, and only an error
+        // leaves LastError() set.
+        if (FillRx() <= 0)
+        {
+            m_rx.PopPartial(limit, line);
+            break;
+        }
+    }
+    return line;
+}
\ No newline at end of file
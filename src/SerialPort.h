@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "RxBuffer.h"
 
 struct PortInfo
 {
@@ -41,12 +42,42 @@ public:
     int  WriteByte(uint8_t b);
 
     // Read up to maxLen bytes; returns bytes read or -1 on error.
+    // Bytes already buffered by ReadLine() are returned first.
     int  Read(uint8_t* buf, int maxLen);
 
     // Read until terminator byte or timeout; terminatorIncluded=false strips it.
     // Returns the line (without terminator) or empty string on timeout/error.
+    // On timeout or error any partial line received so far is returned.
+    // Input is block-read into a per-port ring; bytes after the terminator
+    // are kept for the next call.
     std::string ReadLine(uint8_t terminator = '\r', int maxBytes = 256);
 
+    // --- non-blocking access for multiplexed callers ---
+    // Drain whatever input the driver already holds into the receive
+    // ring without waiting.  Returns bytes added, 0 if none, -1 on error.
+    int  ReadAvailable();
+
+    // Pop the next complete line from input already in the ring; returns
+    // false (line left empty) if no terminator has been received yet.
+    bool NextLine(std::string& line, uint8_t terminator = '\r', int maxBytes = 256);
+
+    // Throw away buffered input, e.g. a partial line after a timeout.
+    void DiscardInput() { m_rx.Clear(); }
+
+    // Contiguous span of buffered input, for callers that parse bytes
+    // in place (DmmStreamParser).  Consume what was used.
+    const uint8_t* PeekInput(size_t& len) const { return m_rx.ReadPtr(len); }
+    void ConsumeInput(size_t n) { m_rx.Consume(n); }
+
+    // Wait up to the port timeout for input and buffer it.  Returns
+    // bytes added, 0 on timeout or end-of-file, -1 on error.
+    int  WaitInput() { m_lastError.clear(); return FillRx(); }
+
+#ifndef _WIN32
+    // Descriptor for epoll/select registration; -1 when closed.
+    int  Fd() const { return m_fd; }
+#endif
+
     std::string LastError() const { return m_lastError; }
 
     // Clear a previous error (e.g. after the caller has handled it).
@@ -55,12 +86,18 @@ public:
 private:
     void SetError(const std::string& msg);
 
+    // Wait up to the port timeout for input, then drain everything the
+    // driver has buffered into m_rx.  Returns bytes added, 0 on timeout
+    // or end-of-file, -1 on error (LastError() set).
+    int  FillRx();
+
 #ifdef _WIN32
     void* m_handle;   // HANDLE
 #else
     int   m_fd;
-    int   m_timeoutMs;  // stored for select()-based ReadLine (fix #7)
+    int   m_timeoutMs;  // stored for select()-based FillRx (fix #7)
 #endif
+    RxBuffer    m_rx;
     std::string m_lastError;
     bool        m_open;
 };
@@ -0,0 +1,545 @@
+// ============================================================
+//  Protek506Logger — SeriesStore.cpp
+// ============================================================
+#include "SeriesStore.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+// ----------------------------------------------------------------
+// Value encoding
+// ----------------------------------------------------------------
+// Non-numeric kinds are quiet NaNs with the kind in the payload; an
+// unparseable numeric token is the payload-0 NaN.
+static const uint64_t NAN_BITS = 0x7FF8000000000000ULL;
+
+static uint64_t ToBits(const DmmSample& s)
+{
+    if (s.kind != DmmValueKind::Numeric)
+        return NAN_BITS | static_cast<uint64_t>(s.kind);
+    if (std::isnan(s.value))
+        return NAN_BITS;
+    uint64_t bits;
+    memcpy(&bits, &s.value, sizeof(bits));
+    return bits;
+}
+
+static void FromBits(uint64_t bits, double& value, DmmValueKind& kind)
+{
+    if ((bits & ~0xFFULL) == NAN_BITS)
+    {
+        kind  = static_cast<DmmValueKind>(bits & 0xFF);
+        value = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    kind = DmmValueKind::Numeric;
+    memcpy(&value, &bits, sizeof(value));
+}
+
+static unsigned LeadingZeros(uint64_t x)
+{
+    unsigned n = 0;
+    for (uint64_t m = 1ULL << 63; m && !(x & m); m >>= 1) ++n;
+    return n;
+}
+
+static unsigned TrailingZeros(uint64_t x)
+{
+    unsigned n = 0;
+    for (; n < 64 && !(x & 1); x >>= 1) ++n;
+    return n;
+}
+
+// ----------------------------------------------------------------
+// Timestamp buckets: control prefix, payload width, bias
+// ----------------------------------------------------------------
+//   0                  dod == 0
+//   10   + 7 bits      -63 ..   64
+//   110  + 9 bits     -255 ..  256
+//   1110 + 12 bits   -2047 .. 2048
+//   1111 + 64 bits     anything (a gap in the capture)
+struct DodBucket { uint64_t prefix; unsigned prefixBits; unsigned bits; int64_t bias; };
+static const DodBucket DOD_BUCKETS[] = {
+    { 0x2, 2,  7,   63 },
+    { 0x6, 3,  9,  255 },
+    { 0xE, 4, 12, 2047 },
+};
+
+// ----------------------------------------------------------------
+// Bit stream
+// ----------------------------------------------------------------
+void SeriesStore::PutBits(Block& b, uint64_t value, unsigned n)
+{
+    if (n == 0) return;
+    if (n < 64) value &= (1ULL << n) - 1;
+
+    unsigned used = static_cast<unsigned>(b.bitLen & 63);
+    if (used == 0)
+        b.words.push_back(0);
+    unsigned room = 64 - used;
+    if (n <= room)
+    {
+        b.words.back() |= value << (room - n);
+    }
+    else
+    {
+        b.words.back() |= value >> (n - room);
+        b.words.push_back(value << (64 - (n - room)));
+    }
+    b.bitLen += n;
+}
+
+namespace
+{
+class BitReader
+{
+public:
+    BitReader(const std::vector<uint64_t>& words, uint64_t bitLen)
+        : m_words(words), m_len(bitLen) {}
+
+    bool Ok() const { return m_pos <= m_len; }
+
+    uint64_t Get(unsigned n)
+    {
+        if (n == 0) return 0;
+        if (m_pos + n > m_len) { m_pos = m_len + 1; return 0; }
+        size_t   w    = static_cast<size_t>(m_pos >> 6);
+        unsigned used = static_cast<unsigned>(m_pos & 63);
+        unsigned room = 64 - used;
+        uint64_t v;
+        if (n <= room)
+        {
+            v = m_words[w] << used;
+            v = n < 64 ? v >> (64 - n) : v;
+        }
+        else
+        {
+            unsigned rest = n - room;
+            v = (m_words[w] << used) >> used;
+            v = (v << rest) | (m_words[w + 1] >> (64 - rest));
+        }
+        m_pos += n;
+        return v;
+    }
+
+    bool Bit() { return Get(1) != 0; }
+
+private:
+    const std::vector<uint64_t>& m_words;
+    uint64_t                     m_len;
+    uint64_t                     m_pos = 0;
+};
+}
+
+// ----------------------------------------------------------------
+// Encoder
+// ----------------------------------------------------------------
+SeriesStore::SeriesStore() {}
+
+void SeriesStore::StartBlock(Block& b, int meter, const DmmSample& s,
+                             int64_t ms, uint64_t bits)
+{
+    b.meter     = meter;
+    b.mode      = s.mode;
+    b.unit      = s.unit;
+    b.count     = 1;
+    b.firstMs   = ms;
+    b.lastMs    = ms;
+    b.firstBits = bits;
+    b.prevBits  = bits;
+    b.prevDelta = 0;
+    b.leading   = 0xFF;
+    b.trailing  = 0;
+    b.minValue  = std::numeric_limits<double>::quiet_NaN();
+    b.maxValue  = b.minValue;
+}
+
+void SeriesStore::Encode(Block& b, int64_t ms, uint64_t bits)
+{
+    size_t before = b.words.size();
+
+    // Timestamp: delta of delta
+    int64_t delta = ms - b.lastMs;
+    int64_t dod   = delta - b.prevDelta;
+    if (dod == 0)
+    {
+        PutBits(b, 0, 1);
+    }
+    else
+    {
+        bool done = false;
+        for (const DodBucket& k : DOD_BUCKETS)
+        {
+            if (dod >= -k.bias && dod <= k.bias + 1)
+            {
+                PutBits(b, k.prefix, k.prefixBits);
+                PutBits(b, static_cast<uint64_t>(dod + k.bias), k.bits);
+                done = true;
+                break;
+            }
+        }
+        if (!done)
+        {
+            PutBits(b, 0xF, 4);
+            PutBits(b, static_cast<uint64_t>(dod), 64);
+        }
+    }
+    b.prevDelta = delta;
+    b.lastMs    = ms;
+
+    // Value: XOR with the previous one
+    uint64_t x = bits ^ b.prevBits;
+    if (x == 0)
+    {
+        PutBits(b, 0, 1);
+    }
+    else
+    {
+        unsigned lead  = LeadingZeros(x);
+        unsigned trail = TrailingZeros(x);
+        if (lead > 31) lead = 31;               // 5-bit field
+
+        if (b.leading != 0xFF && lead >= b.leading && trail >= b.trailing)
+        {
+            PutBits(b, 0x2, 2);
+            PutBits(b, x >> b.trailing, 64 - b.leading - b.trailing);
+        }
+        else
+        {
+            unsigned sig = 64 - lead - trail;   // 1..64, stored as sig - 1
+            PutBits(b, 0x3, 2);
+            PutBits(b, lead, 5);
+            PutBits(b, sig - 1, 6);
+            PutBits(b, x >> trail, sig);
+            b.leading  = static_cast<uint8_t>(lead);
+            b.trailing = static_cast<uint8_t>(trail);
+        }
+    }
+    b.prevBits = bits;
+    ++b.count;
+
+    m_bytes += (b.words.size() - before) * sizeof(uint64_t);
+}
+
+void SeriesStore::Append(int meter, const DmmSample& s)
+{
+    const int64_t  ms   = s.monoUs / 1000;
+    const uint64_t bits = ToBits(s);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_haveOffset)
+    {
+        m_wallOffsetUs = s.wallUs - s.monoUs;
+        m_haveOffset   = true;
+    }
+
+    Block* b   = nullptr;
+    auto   it  = m_open.find(meter);
+    if (it != m_open.end())
+    {
+        Block& open = m_blocks[it->second];
+        if (open.mode == s.mode && open.unit == s.unit &&
+            open.count < kBlockSamples && ms >= open.lastMs)
+            b = &open;
+    }
+
+    if (b)
+    {
+        Encode(*b, ms, bits);
+    }
+    else
+    {
+        // Seal the old block (it simply stops growing) and start a new one.
+        m_blocks.emplace_back();
+        m_open[meter] = m_blocks.size() - 1;
+        b = &m_blocks.back();
+        StartBlock(*b, meter, s, ms, bits);
+    }
+    ++m_samples;
+
+    if (s.kind == DmmValueKind::Numeric && !std::isnan(s.value))
+    {
+        if (std::isnan(b->minValue) || s.value < b->minValue) b->minValue = s.value;
+        if (std::isnan(b->maxValue) || s.value > b->maxValue) b->maxValue = s.value;
+    }
+}
+
+void SeriesStore::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_blocks.clear();
+    m_open.clear();
+    m_samples    = 0;
+    m_bytes      = 0;
+    m_haveOffset = false;
+}
+
+// ----------------------------------------------------------------
+// Decoder
+// ----------------------------------------------------------------
+void SeriesStore::Decode(const Block& b, std::vector<SeriesPoint>& out)
+{
+    if (b.count == 0) return;
+    out.reserve(out.size() + b.count);
+
+    SeriesPoint p;
+    int64_t  ms   = b.firstMs;
+    uint64_t bits = b.firstBits;
+    p.monoUs = ms * 1000;
+    FromBits(bits, p.value, p.kind);
+    out.push_back(p);
+
+    BitReader r(b.words, b.bitLen);
+    int64_t  delta   = 0;
+    unsigned leading = 0, trailing = 0;
+
+    for (uint32_t i = 1; i < b.count; ++i)
+    {
+        // Timestamp
+        int64_t dod = 0;
+        if (r.Bit())
+        {
+            const DodBucket* k = nullptr;
+            for (const DodBucket& c : DOD_BUCKETS)
+            {
+                if (!r.Bit()) { k = &c; break; }
+            }
+            if (k)
+                dod = static_cast<int64_t>(r.Get(k->bits)) - k->bias;
+            else
+                dod = static_cast<int64_t>(r.Get(64));
+        }
+        delta += dod;
+        ms    += delta;
+
+        // Value
+        if (r.Bit())
+        {
+            if (r.Bit())
+            {
+                leading  = static_cast<unsigned>(r.Get(5));
+                unsigned sig = static_cast<unsigned>(r.Get(6)) + 1;
+                trailing = 64 - leading - sig;
+            }
+            bits ^= r.Get(64 - leading - trailing) << trailing;
+        }
+
+        if (!r.Ok()) break;             // truncated block: keep what decoded
+        p.monoUs = ms * 1000;
+        FromBits(bits, p.value, p.kind);
+        out.push_back(p);
+    }
+}
+
+// ----------------------------------------------------------------
+// Queries
+// ----------------------------------------------------------------
+size_t SeriesStore::BlockCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_blocks.size();
+}
+
+bool SeriesStore::BlockInfo(size_t index, SeriesBlockInfo& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index >= m_blocks.size()) return false;
+    const Block& b = m_blocks[index];
+    out.meter    = b.meter;
+    out.mode     = b.mode;
+    out.unit     = b.unit;
+    out.count    = b.count;
+    out.firstUs  = b.firstMs * 1000;
+    out.lastUs   = b.lastMs * 1000;
+    out.minValue = b.minValue;
+    out.maxValue = b.maxValue;
+    out.bytes    = b.words.size() * sizeof(uint64_t);
+    return true;
+}
+
+bool SeriesStore::DecodeBlock(size_t index, std::vector<SeriesPoint>& out) const
+{
+    // Copy the bits out so the reader thread is not held up by decoding.
+    Block copy;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (index >= m_blocks.size()) return false;
+        copy = m_blocks[index];
+    }
+    Decode(copy, out);
+    return true;
+}
+
+uint64_t SeriesStore::SampleCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples;
+}
+
+size_t SeriesStore::BytesUsed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+int64_t SeriesStore::WallOffsetUs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wallOffsetUs;
+}
+
+std::string SeriesStore::LastError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+// ----------------------------------------------------------------
+// Save / Load
+// ----------------------------------------------------------------
+// File: FileHeader, then per block a BlockHeader followed by its
+// words.  Host byte order, like the binary session log.
+namespace
+{
+const char FILE_MAGIC[8] = { 'P', '5', '0', '6', 'S', 'E', 'R', '\x01' };
+
+struct FileHeader
+{
+    char     magic[8];
+    int64_t  wallOffsetUs;
+    uint64_t blockCount;
+    uint64_t sampleCount;
+};
+
+struct BlockHeader
+{
+    int32_t  meter;
+    uint8_t  mode;
+    uint8_t  unit;
+    uint16_t reserved;
+    uint32_t count;
+    uint32_t wordCount;
+    uint64_t bitLen;
+    int64_t  firstMs;
+    int64_t  lastMs;
+    uint64_t firstBits;
+    double   minValue;
+    double   maxValue;
+};
+static_assert(sizeof(BlockHeader) == 64, "BlockHeader layout");
+}
+
+bool SeriesStore::Save(const std::string& filePath)
+{
+    // Snapshot under the lock, write without it.
+    std::vector<Block> blocks;
+    FileHeader fh;
+    memcpy(fh.magic, FILE_MAGIC, sizeof(fh.magic));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        blocks          = m_blocks;
+        fh.wallOffsetUs = m_wallOffsetUs;
+        fh.sampleCount  = m_samples;
+    }
+    fh.blockCount = blocks.size();
+
+    FILE* fp = fopen(filePath.c_str(), "wb");
+    bool ok = fp && fwrite(&fh, sizeof(fh), 1, fp) == 1;
+    for (size_t i = 0; ok && i < blocks.size(); ++i)
+    {
+        const Block& b = blocks[i];
+        BlockHeader bh;
+        memset(&bh, 0, sizeof(bh));
+        bh.meter     = b.meter;
+        bh.mode      = static_cast<uint8_t>(b.mode);
+        bh.unit      = static_cast<uint8_t>(b.unit);
+        bh.count     = b.count;
+        bh.wordCount = static_cast<uint32_t>(b.words.size());
+        bh.bitLen    = b.bitLen;
+        bh.firstMs   = b.firstMs;
+        bh.lastMs    = b.lastMs;
+        bh.firstBits = b.firstBits;
+        bh.minValue  = b.minValue;
+        bh.maxValue  = b.maxValue;
+        ok = fwrite(&bh, sizeof(bh), 1, fp) == 1 &&
+             (b.words.empty() ||
+              fwrite(b.words.data(), sizeof(uint64_t), b.words.size(), fp) == b.words.size());
+    }
+    if (fp && fclose(fp) != 0)
+        ok = false;
+
+    if (!ok)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = fp ? "Write error on " + filePath + " (disk full?)"
+                         : "Cannot open file: " + filePath;
+    }
+    return ok;
+}
+
+bool SeriesStore::Load(const std::string& filePath)
+{
+    FILE* fp = fopen(filePath.c_str(), "rb");
+    if (!fp)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = "Cannot open file: " + filePath;
+        return false;
+    }
+
+    std::vector<Block> blocks;
+    uint64_t samples = 0;
+    size_t   bytes   = 0;
+    FileHeader fh;
+    bool ok = fread(&fh, sizeof(fh), 1, fp) == 1 &&
+              memcmp(fh.magic, FILE_MAGIC, sizeof(fh.magic)) == 0;
+    if (ok)
+        blocks.reserve(static_cast<size_t>(fh.blockCount));
+    for (uint64_t i = 0; ok && i < fh.blockCount; ++i)
+    {
+        BlockHeader bh;
+        if (fread(&bh, sizeof(bh), 1, fp) != 1 ||
+            bh.bitLen > static_cast<uint64_t>(bh.wordCount) * 64)
+        {
+            ok = false;
+            break;
+        }
+        blocks.emplace_back();
+        Block& b = blocks.back();
+        b.meter     = bh.meter;
+        b.mode      = static_cast<DmmMode>(bh.mode);
+        b.unit      = static_cast<DmmUnit>(bh.unit);
+        b.count     = bh.count;
+        b.bitLen    = bh.bitLen;
+        b.firstMs   = bh.firstMs;
+        b.lastMs    = bh.lastMs;
+        b.firstBits = bh.firstBits;
+        b.minValue  = bh.minValue;
+        b.maxValue  = bh.maxValue;
+        b.words.resize(bh.wordCount);
+        if (bh.wordCount &&
+            fread(b.words.data(), sizeof(uint64_t), bh.wordCount, fp) != bh.wordCount)
+        {
+            ok = false;
+            break;
+        }
+        samples += b.count;
+        bytes   += b.words.size() * sizeof(uint64_t);
+    }
+    fclose(fp);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!ok)
+    {
+        m_lastError = "Not a history file, or truncated: " + filePath;
+        return false;
+    }
+    m_blocks.swap(blocks);
+    m_open.clear();                     // loaded blocks are sealed
+    m_samples      = samples;
+    m_bytes        = bytes;
+    m_wallOffsetUs = fh.wallOffsetUs;
+    m_haveOffset   = true;
+    return true;
+}
@@ -0,0 +1,122 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — SeriesStore.h
+//  In-memory, append-only store of reading series, compressed
+//  Gorilla-style (Pelkonen et al., "Gorilla: A Fast, Scalable,
+//  In-Memory Time Series Database", VLDB 2015).
+//
+//  Samples are grouped into blocks; a block holds one meter's
+//  readings for one mode + unit run and is sealed after
+//  kBlockSamples samples or when the mode or unit changes.
+//  Inside a block:
+//    - timestamps (milliseconds, monotonic) are stored as the
+//      delta of the previous delta: at a steady poll rate that
+//      is 0 and costs one bit;
+//    - values are XORed with the previous value and only the
+//      changed bits are stored, reusing the previous leading /
+//      trailing-zero window when it still fits.
+//  Special values (OL, OPEN, ...) are stored as NaNs whose
+//  payload is the DmmValueKind, so a run of OL is also one bit
+//  per sample.  The raw line is not kept.
+//
+//  Save() writes the blocks exactly as they are held in memory
+//  and Load() reads them back without decoding anything, so a
+//  month-long capture opens as fast as the file can be read.
+//
+//  Thread-safe: the reader thread appends while the GUI reads.
+// ============================================================
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DmmParser.h"
+
+struct SeriesPoint
+{
+    int64_t      monoUs;        // steady_clock µs (millisecond resolution)
+    double       value;         // NaN unless kind is Numeric
+    DmmValueKind kind;
+};
+
+struct SeriesBlockInfo
+{
+    int      meter;
+    DmmMode  mode;
+    DmmUnit  unit;
+    uint32_t count;             // samples in the block
+    int64_t  firstUs;           // steady_clock µs of the first / last sample
+    int64_t  lastUs;
+    double   minValue;          // over numeric samples; NaN if none
+    double   maxValue;
+    size_t   bytes;             // compressed payload size
+};
+
+class SeriesStore
+{
+public:
+    static constexpr uint32_t kBlockSamples = 4096;
+
+    SeriesStore();
+
+    SeriesStore(const SeriesStore&) = delete;
+    SeriesStore& operator=(const SeriesStore&) = delete;
+
+    // Streaming encoder: add one sample from meter 'meter'.
+    void Append(int meter, const DmmSample& s);
+
+    void Clear();
+
+    // Block access, oldest first.  The last block of each meter may
+    // still be growing; DecodeBlock() returns what it holds so far.
+    size_t BlockCount() const;
+    bool   BlockInfo(size_t index, SeriesBlockInfo& out) const;
+    bool   DecodeBlock(size_t index, std::vector<SeriesPoint>& out) const;   // appends
+
+    uint64_t SampleCount() const;
+    size_t   BytesUsed() const;        // compressed payload, all blocks
+
+    // wall-clock µs = monotonic µs + WallOffsetUs(), from the first sample
+    int64_t  WallOffsetUs() const;
+
+    bool Save(const std::string& filePath);
+    bool Load(const std::string& filePath);     // replaces the contents
+    std::string LastError() const;
+
+private:
+    struct Block
+    {
+        int      meter     = 0;
+        DmmMode  mode      = DmmMode::Unknown;
+        DmmUnit  unit      = DmmUnit::None;
+        uint32_t count     = 0;
+        int64_t  firstMs   = 0;
+        int64_t  lastMs    = 0;
+        uint64_t firstBits = 0;         // first value, as stored
+        double   minValue  = 0.0;
+        double   maxValue  = 0.0;
+        uint64_t bitLen    = 0;
+        std::vector<uint64_t> words;    // bit stream, MSB first
+
+        // Encoder state; not saved (a loaded block is sealed)
+        int64_t  prevDelta = 0;
+        uint64_t prevBits  = 0;
+        uint8_t  leading   = 0xFF;      // 0xFF: no window yet
+        uint8_t  trailing  = 0;
+    };
+
+    void StartBlock(Block& b, int meter, const DmmSample& s, int64_t ms, uint64_t bits);
+    void Encode(Block& b, int64_t ms, uint64_t bits);
+    static void PutBits(Block& b, uint64_t value, unsigned n);
+    static void Decode(const Block& b, std::vector<SeriesPoint>& out);
+
+    mutable std::mutex    m_mutex;
+    std::vector<Block>    m_blocks;
+    std::map<int, size_t> m_open;        // meter → index of its growing block
+    uint64_t              m_samples      = 0;
+    size_t                m_bytes        = 0;
+    int64_t               m_wallOffsetUs = 0;
+    bool                  m_haveOffset   = false;
+    std::string           m_lastError;
+};
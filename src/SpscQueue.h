@@ -0,0 +1,116 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — SpscQueue.h
+//  Lock-free single-producer / single-consumer ring.
+//
+//  Used between ReaderThread (producer) and MainFrame (consumer)
+//  so a reading costs one copy into a preallocated slot instead
+//  of a heap-allocated wxEvent.  Exactly one thread may call the
+//  producer functions and exactly one the consumer functions.
+//
+//  Head and tail are free-running; each side keeps a private
+//  cached copy of the other's index and only re-reads the shared
+//  atomic when the cache says the ring looks full / empty.
+//
+//  The "signal" latch lets the producer coalesce wakeups: only
+//  the push that finds the latch clear needs to notify the
+//  consumer, which clears it just before it drains.
+// ============================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+template <typename T, size_t N>
+class SpscQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscQueue slots are copied, not constructed");
+
+public:
+    static constexpr size_t kCapacity = N;
+
+    // ---- producer ----
+
+    // Copy 'item' into the ring.  Returns false (and counts a drop) if
+    // the consumer has fallen a full ring behind.
+    bool TryPush(const T& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == N)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == N)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_items[tail & kMask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        const size_t depth = tail + 1 - m_head.load(std::memory_order_relaxed);
+        if (depth > m_highWater.load(std::memory_order_relaxed))
+            m_highWater.store(depth, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Set the wakeup latch.  Returns true if it was clear, i.e. the
+    // consumer has to be notified; false if a notification is pending.
+    bool Signal()
+    {
+        return !m_signalled.exchange(true, std::memory_order_acq_rel);
+    }
+
+    // ---- consumer ----
+
+    bool TryPop(T& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+                return false;
+        }
+        out = m_items[head & kMask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Clear the wakeup latch before draining, so any push that lands
+    // after the drain sends a fresh notification.
+    void ClearSignal()
+    {
+        m_signalled.exchange(false, std::memory_order_acq_rel);
+    }
+
+    // ---- counters (any thread; approximate while running) ----
+
+    size_t Depth() const
+    {
+        return m_tail.load(std::memory_order_acquire) -
+               m_head.load(std::memory_order_acquire);
+    }
+    bool     Empty()     const { return Depth() == 0; }
+    size_t   HighWater() const { return m_highWater.load(std::memory_order_relaxed); }
+    uint64_t Dropped()   const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kMask = N - 1;
+
+    // Consumer-owned line
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t                          m_tailCache = 0;
+
+    // Producer-owned line
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t                          m_headCache = 0;
+    std::atomic<size_t>             m_highWater{0};
+    std::atomic<uint64_t>           m_dropped{0};
+
+    alignas(64) std::atomic<bool>   m_signalled{false};
+
+    T m_items[N];
+};
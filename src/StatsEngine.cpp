@@ -0,0 +1,302 @@
+// ============================================================
+//  Protek506Logger — StatsEngine.cpp
+// ============================================================
+#include "StatsEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+// ----------------------------------------------------------------
+// P² quantile estimator
+// ----------------------------------------------------------------
+void P2Quantile::Add(double x)
+{
+    if (m_n < 5)
+    {
+        m_q[m_n++] = x;
+        if (m_n == 5)
+        {
+            std::sort(m_q, m_q + 5);
+            for (int i = 0; i < 5; ++i) m_pos[i] = i + 1;
+            m_np[0] = 1;  m_np[1] = 1 + 2 * m_p;  m_np[2] = 1 + 4 * m_p;
+            m_np[3] = 3 + 2 * m_p;  m_np[4] = 5;
+            m_dn[0] = 0;  m_dn[1] = m_p / 2;  m_dn[2] = m_p;
+            m_dn[3] = (1 + m_p) / 2;  m_dn[4] = 1;
+        }
+        return;
+    }
+
+    // Cell k the sample falls into; the extreme markers track min / max.
+    int k;
+    if (x < m_q[0])       { m_q[0] = x; k = 0; }
+    else if (x >= m_q[4]) { m_q[4] = x; k = 3; }
+    else
+    {
+        k = 0;
+        while (x >= m_q[k + 1]) ++k;
+    }
+    for (int i = k + 1; i < 5; ++i) m_pos[i] += 1;
+    for (int i = 0; i < 5; ++i)     m_np[i]  += m_dn[i];
+    ++m_n;
+
+    // Nudge the three middle markers towards their desired positions.
+    for (int i = 1; i <= 3; ++i)
+    {
+        double d = m_np[i] - m_pos[i];
+        if ((d >= 1 && m_pos[i + 1] - m_pos[i] > 1) ||
+            (d <= -1 && m_pos[i - 1] - m_pos[i] < -1))
+        {
+            double s = d > 0 ? 1.0 : -1.0;
+            // Piecewise-parabolic prediction ...
+            double qp = m_q[i] + s / (m_pos[i + 1] - m_pos[i - 1]) *
+                ((m_pos[i] - m_pos[i - 1] + s) * (m_q[i + 1] - m_q[i]) /
+                     (m_pos[i + 1] - m_pos[i]) +
+                 (m_pos[i + 1] - m_pos[i] - s) * (m_q[i] - m_q[i - 1]) /
+                     (m_pos[i] - m_pos[i - 1]));
+            // ... or linear if that would break the ordering.
+            if (qp <= m_q[i - 1] || qp >= m_q[i + 1])
+            {
+                int j = i + static_cast<int>(s);
+                qp = m_q[i] + s * (m_q[j] - m_q[i]) / (m_pos[j] - m_pos[i]);
+            }
+            m_q[i]    = qp;
+            m_pos[i] += s;
+        }
+    }
+}
+
+double P2Quantile::Value() const
+{
+    if (m_n == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (m_n >= 5)
+        return m_q[2];
+    // Too few samples for markers: exact, from the sorted samples
+    double v[5];
+    std::copy(m_q, m_q + m_n, v);
+    std::sort(v, v + m_n);
+    return v[static_cast<int>(std::lround(m_p * (m_n - 1)))];
+}
+
+// ----------------------------------------------------------------
+// Sliding window
+// ----------------------------------------------------------------
+void StatsEngine::Window::Reset(size_t maxCount, int64_t maxUs)
+{
+    m_maxCount = maxCount;
+    m_maxUs    = maxUs;
+    m_seq      = 0;
+    m_items.clear();
+    m_minQ.clear();
+    m_maxQ.clear();
+    m_mean = 0.0;
+    m_m2   = 0.0;
+}
+
+void StatsEngine::Window::PopFront()
+{
+    Entry e = m_items.front();
+    m_items.pop_front();
+    if (!m_minQ.empty() && m_minQ.front().seq == e.seq) m_minQ.pop_front();
+    if (!m_maxQ.empty() && m_maxQ.front().seq == e.seq) m_maxQ.pop_front();
+
+    // Welford, run backwards
+    size_t n = m_items.size();
+    if (n == 0)
+    {
+        m_mean = 0.0;
+        m_m2   = 0.0;
+        return;
+    }
+    double d = e.x - m_mean;
+    m_mean  -= d / static_cast<double>(n);
+    m_m2    -= d * (e.x - m_mean);
+    if (m_m2 < 0.0) m_m2 = 0.0;
+}
+
+void StatsEngine::Window::Add(int64_t t, double x)
+{
+    Entry e = { m_seq++, t, x };
+    m_items.push_back(e);
+    double d = x - m_mean;
+    m_mean  += d / static_cast<double>(m_items.size());
+    m_m2    += d * (x - m_mean);
+
+    while (!m_minQ.empty() && m_minQ.back().x >= x) m_minQ.pop_back();
+    m_minQ.push_back(e);
+    while (!m_maxQ.empty() && m_maxQ.back().x <= x) m_maxQ.pop_back();
+    m_maxQ.push_back(e);
+
+    if (m_maxCount > 0)
+        while (m_items.size() > m_maxCount) PopFront();
+    if (m_maxUs > 0)
+        while (!m_items.empty() && m_items.front().t < t - m_maxUs) PopFront();
+}
+
+WindowStats StatsEngine::Window::Stats() const
+{
+    WindowStats w;
+    w.count = m_items.size();
+    if (w.count == 0) return w;
+    w.mean   = m_mean;
+    w.stddev = w.count > 1 ? std::sqrt(m_m2 / static_cast<double>(w.count - 1)) : 0.0;
+    w.min    = m_minQ.front().x;
+    w.max    = m_maxQ.front().x;
+    return w;
+}
+
+// ----------------------------------------------------------------
+// Engine
+// ----------------------------------------------------------------
+StatsEngine::StatsEngine()
+{
+    ResetLocked();
+}
+
+bool StatsEngine::IsStatMode(DmmMode mode)
+{
+    return mode == DmmMode::DC  || mode == DmmMode::AC  ||
+           mode == DmmMode::RES || mode == DmmMode::TEMP ||
+           mode == DmmMode::CAP || mode == DmmMode::IND;
+}
+
+void StatsEngine::SetWindows(size_t samples, int64_t us)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_windowSamples = samples > 0 ? samples : 1;
+    m_windowUs      = us > 0 ? us : 1000000;
+}
+
+void StatsEngine::ResetLocked()
+{
+    m_count = 0;
+    m_mean  = 0.0;
+    m_m2    = 0.0;
+    m_min   = 0.0;
+    m_max   = 0.0;
+    m_p01.Reset();
+    m_p50.Reset();
+    m_p99.Reset();
+    m_lastN.Reset(m_windowSamples, 0);
+    m_lastT.Reset(0, m_windowUs);
+    m_histogram.Reset();
+}
+
+void StatsEngine::Start(DmmMode mode, DmmUnit baseUnit)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ResetLocked();
+    m_mode = mode;
+    m_unit = baseUnit;
+    m_running.store(true);
+}
+
+void StatsEngine::Stop()
+{
+    m_running.store(false);
+}
+
+void StatsEngine::Add(const DmmSample& s)
+{
+    if (!m_running.load(std::memory_order_relaxed)) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running.load()) return;
+
+    // Another quantity: the run is over.  A stat-eligible one also
+    // clears it (the old figures would be in the wrong unit).
+    if (s.mode != m_mode || DmmBaseUnit(s.unit) != m_unit)
+    {
+        m_running.store(false);
+        if (IsStatMode(s.mode))
+            ResetLocked();
+        return;
+    }
+
+    // OL and other non-numeric readings carry NaN and are skipped.
+    double x = s.scaled;
+    if (std::isnan(x)) return;
+
+    ++m_count;
+    double d = x - m_mean;
+    m_mean  += d / static_cast<double>(m_count);
+    m_m2    += d * (x - m_mean);
+    if (m_count == 1)     { m_min = x; m_max = x; }
+    else if (x < m_min)   m_min = x;
+    else if (x > m_max)   m_max = x;
+
+    m_p01.Add(x);
+    m_p50.Add(x);
+    m_p99.Add(x);
+    m_lastN.Add(s.monoUs, x);
+    m_lastT.Add(s.monoUs, x);
+    m_histogram.Add(x, StreamHistogram::Resolution(s));
+}
+
+StatsSnapshot StatsEngine::Snapshot() const
+{
+    StatsSnapshot snap;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snap.running = m_running.load();
+    snap.mode    = m_mode;
+    snap.unit    = m_unit;
+    snap.count   = m_count;
+    snap.windowSamples = m_windowSamples;
+    snap.windowUs      = m_windowUs;
+    if (m_count == 0) return snap;
+
+    snap.min    = m_min;
+    snap.max    = m_max;
+    snap.mean   = m_mean;
+    snap.stddev = m_count > 1 ? std::sqrt(m_m2 / static_cast<double>(m_count - 1)) : 0.0;
+    snap.p01    = m_p01.Value();
+    snap.p50    = m_p50.Value();
+    snap.p99    = m_p99.Value();
+    snap.lastN  = m_lastN.Stats();
+    snap.lastT  = m_lastT.Stats();
+    snap.histogram = m_histogram.Data();
+    return snap;
+}
+
+// ----------------------------------------------------------------
+// Export
+// ----------------------------------------------------------------
+bool StatsEngine::ExportCsv(const StatsSnapshot& snap, const std::string& filePath)
+{
+    FILE* fp = fopen(filePath.c_str(), "w");
+    if (!fp) return false;
+
+    const char* unit = DmmUnitText(snap.unit);
+    auto row = [fp, unit](const char* name, double v) {
+        fprintf(fp, "%s,%.9g,%s\n", name, v, unit);
+    };
+    auto window = [fp, &row](const std::string& tag, const WindowStats& w) {
+        fprintf(fp, "%s count,%llu,\n", tag.c_str(),
+                static_cast<unsigned long long>(w.count));
+        row((tag + " mean").c_str(),   w.mean);
+        row((tag + " stddev").c_str(), w.stddev);
+        row((tag + " min").c_str(),    w.min);
+        row((tag + " max").c_str(),    w.max);
+    };
+
+    fprintf(fp, "Statistic,Value,Units\n");
+    fprintf(fp, "mode,%s,\n", DmmModeName(snap.mode));
+    fprintf(fp, "count,%llu,\n", static_cast<unsigned long long>(snap.count));
+    row("min",    snap.min);
+    row("max",    snap.max);
+    row("mean",   snap.mean);
+    row("stddev", snap.stddev);
+    row("p1",     snap.p01);
+    row("p50",    snap.p50);
+    row("p99",    snap.p99);
+
+    char tag[64];
+    snprintf(tag, sizeof(tag), "last %zu", snap.windowSamples);
+    window(tag, snap.lastN);
+    snprintf(tag, sizeof(tag), "last %gs", snap.windowUs / 1e6);
+    window(tag, snap.lastT);
+
+    bool ok = !ferror(fp);
+    return fclose(fp) == 0 && ok;
+}
@@ -0,0 +1,154 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — StatsEngine.h
+//  Streaming statistics for the stats panel, computed on the
+//  reader thread in O(1) (amortised) per sample.
+//
+//    - count / mean / variance: Welford's online algorithm;
+//    - p1 / p50 / p99: P² estimators (Jain & Chlamtac, 1985),
+//      five markers each, no samples kept;
+//    - rolling windows over the last N samples and the last T
+//      seconds: mean / standard deviation with Welford's add
+//      and remove updates, min / max from monotonic deques.
+//
+//  A StreamHistogram of the run's values is kept alongside and
+//  copied out with each snapshot.
+//
+//  Values are in SI base units (DmmSample::scaled).  A run is
+//  tied to the mode + base unit it was started in; a reading
+//  of another quantity stops it, and clears it if that reading
+//  is itself stat-eligible, as the panel always did.
+//
+//  Add() belongs to the reader thread; Start(), Stop() and
+//  Snapshot() may be called from any thread.
+// ============================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include "DmmParser.h"
+#include "StreamHistogram.h"
+
+// Estimate of one quantile without storing the samples.
+class P2Quantile
+{
+public:
+    explicit P2Quantile(double p = 0.5) : m_p(p) {}
+
+    void   Reset() { m_n = 0; }
+    void   Add(double x);
+    double Value() const;       // NaN before the first sample
+
+private:
+    double m_p;
+    int    m_n = 0;
+    double m_q[5]   = {};       // marker heights
+    double m_pos[5] = {};       // actual marker positions
+    double m_np[5]  = {};       // desired marker positions
+    double m_dn[5]  = {};       // desired position increments
+};
+
+struct WindowStats
+{
+    uint64_t count  = 0;
+    double   mean   = 0.0;
+    double   stddev = 0.0;
+    double   min    = 0.0;
+    double   max    = 0.0;
+};
+
+struct StatsSnapshot
+{
+    bool     running = false;
+    DmmMode  mode    = DmmMode::Unknown;
+    DmmUnit  unit    = DmmUnit::None;    // base unit of all values below
+    uint64_t count   = 0;                // numeric samples
+    double   min     = 0.0;
+    double   max     = 0.0;
+    double   mean    = 0.0;
+    double   stddev  = 0.0;              // sample standard deviation
+    double   p01     = 0.0;
+    double   p50     = 0.0;
+    double   p99     = 0.0;
+
+    size_t      windowSamples = 0;       // configured window sizes
+    int64_t     windowUs      = 0;
+    WindowStats lastN;                   // last windowSamples samples
+    WindowStats lastT;                   // samples of the last windowUs
+
+    HistogramSnapshot histogram;         // distribution of the run's values
+};
+
+class StatsEngine
+{
+public:
+    StatsEngine();
+
+    StatsEngine(const StatsEngine&) = delete;
+    StatsEngine& operator=(const StatsEngine&) = delete;
+
+    // Window sizes; take effect on the next Start().
+    void SetWindows(size_t samples, int64_t us);
+
+    // Begin a fresh run for one quantity; discards the previous one.
+    void Start(DmmMode mode, DmmUnit baseUnit);
+    // End the run; its figures stay available.
+    void Stop();
+
+    // Reader thread: account one reading (no-op unless running).
+    void Add(const DmmSample& s);
+
+    StatsSnapshot Snapshot() const;
+
+    // Modes the panel offers statistics for.
+    static bool IsStatMode(DmmMode mode);
+
+    // Write a snapshot as "statistic,value,unit" rows.
+    static bool ExportCsv(const StatsSnapshot& snap, const std::string& filePath);
+
+private:
+    // Sliding window: Welford with removal, plus monotonic deques.
+    class Window
+    {
+    public:
+        void Reset(size_t maxCount, int64_t maxUs);
+        void Add(int64_t t, double x);
+        WindowStats Stats() const;
+
+    private:
+        struct Entry { uint64_t seq; int64_t t; double x; };
+        void PopFront();
+
+        size_t   m_maxCount = 0;            // 0 = unbounded
+        int64_t  m_maxUs    = 0;            // 0 = unbounded
+        uint64_t m_seq      = 0;
+        std::deque<Entry> m_items;
+        std::deque<Entry> m_minQ;           // increasing x
+        std::deque<Entry> m_maxQ;           // decreasing x
+        double   m_mean     = 0.0;
+        double   m_m2       = 0.0;
+    };
+
+    void ResetLocked();
+
+    std::atomic<bool> m_running{false};     // fast path for Add()
+    mutable std::mutex m_mutex;             // guards everything below
+
+    DmmMode  m_mode  = DmmMode::Unknown;
+    DmmUnit  m_unit  = DmmUnit::None;
+    uint64_t m_count = 0;
+    double   m_mean  = 0.0;
+    double   m_m2    = 0.0;
+    double   m_min   = 0.0;
+    double   m_max   = 0.0;
+    P2Quantile m_p01{0.01};
+    P2Quantile m_p50{0.50};
+    P2Quantile m_p99{0.99};
+    Window   m_lastN;
+    Window   m_lastT;
+    StreamHistogram m_histogram;
+    size_t   m_windowSamples = 100;
+    int64_t  m_windowUs      = 60LL * 1000000;
+};
@@ -0,0 +1,145 @@
+// ============================================================
+//  Protek506Logger — StreamHistogram.cpp
+// ============================================================
+#include "StreamHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+void StreamHistogram::Reset()
+{
+    m_data  = HistogramSnapshot();
+    m_mant  = 1;
+    m_exp   = 0;
+    m_first = 0;
+    m_last  = -1;
+}
+
+double StreamHistogram::Resolution(const DmmSample& s)
+{
+    if (s.kind != DmmValueKind::Numeric || s.valueLen == 0) return 0.0;
+
+    // Digits after the decimal point (a space in the TEMP "0802 5" form)
+    int  decimals = 0;
+    bool frac     = false;
+    for (int i = 0; i < s.valueLen; ++i)
+    {
+        char c = s.raw[s.valueOff + i];
+        if (c == '.' || c == ' ')             frac = true;
+        else if (frac && c >= '0' && c <= '9') ++decimals;
+    }
+    return std::pow(10.0, -decimals) * DmmUnitScale(s.unit);
+}
+
+int64_t StreamHistogram::GridIndex(double x) const
+{
+    // Readings are whole multiples of the resolution; the nudge keeps
+    // k * w from landing in bin k - 1 through rounding.
+    return static_cast<int64_t>(std::floor(x / m_data.width + 1e-6));
+}
+
+// Move the occupied bins so that grid indices [lo, hi] fit, roughly
+// centred.  False if the span is wider than the histogram.
+bool StreamHistogram::Rebase(int64_t lo, int64_t hi)
+{
+    if (hi - lo + 1 > kBins) return false;
+    int64_t newBase = lo - (kBins - (hi - lo + 1)) / 2;
+    int64_t shift   = newBase - m_data.base;
+    if (shift == 0) return true;
+
+    m_scratch.fill(0);
+    for (int i = m_first; i <= m_last; ++i)
+        m_scratch[static_cast<size_t>(i - shift)] = m_data.counts[static_cast<size_t>(i)];
+    m_data.counts = m_scratch;
+    m_data.base   = newBase;
+    m_first      -= static_cast<int>(shift);
+    m_last       -= static_cast<int>(shift);
+    return true;
+}
+
+// Merge groups of 2 (1 → 2) or 5 (2 → 10) adjacent bins.
+void StreamHistogram::Widen()
+{
+    const int factor = m_mant == 1 ? 2 : 5;
+    auto floorDiv = [factor](int64_t a) {
+        return a >= 0 ? a / factor : -((-a + factor - 1) / factor);
+    };
+
+    const int64_t newBase = floorDiv(m_data.base + m_first);
+    m_scratch.fill(0);
+    int first = kBins, last = -1;
+    for (int i = m_first; i <= m_last; ++i)
+    {
+        uint64_t n = m_data.counts[static_cast<size_t>(i)];
+        if (n == 0) continue;
+        int j = static_cast<int>(floorDiv(m_data.base + i) - newBase);
+        m_scratch[static_cast<size_t>(j)] += n;
+        first = std::min(first, j);
+        last  = std::max(last, j);
+    }
+    m_data.counts = m_scratch;
+    m_data.base   = newBase;
+    m_first       = first;
+    m_last        = last;
+
+    if (m_mant == 1) m_mant = 2;
+    else           { m_mant = 1; ++m_exp; }
+    m_data.width = m_mant * std::pow(10.0, m_exp);
+}
+
+void StreamHistogram::Add(double x, double resolution)
+{
+    if (std::isnan(x)) return;
+
+    if (m_data.total == 0)
+    {
+        // Start on the meter's own step, as a decimal 1 × 10^n.
+        if (!(resolution > 0.0))
+            resolution = x != 0.0 ? std::fabs(x) * 1e-4 : 1e-6;
+        m_mant = 1;
+        m_exp  = static_cast<int>(std::floor(std::log10(resolution) + 1e-9));
+        m_data.width = std::pow(10.0, m_exp);
+        m_data.base  = GridIndex(x) - kBins / 2;
+        m_first = m_last = kBins / 2;
+        m_data.counts[kBins / 2] = 1;
+        m_data.total = 1;
+        return;
+    }
+
+    int64_t g = GridIndex(x);
+    int64_t i = g - m_data.base;
+    while (i < 0 || i >= kBins)
+    {
+        int64_t lo = std::min(g, m_data.base + m_first);
+        int64_t hi = std::max(g, m_data.base + m_last);
+        if (!Rebase(lo, hi))
+            Widen();
+        g = GridIndex(x);
+        i = g - m_data.base;
+    }
+
+    ++m_data.counts[static_cast<size_t>(i)];
+    ++m_data.total;
+    m_first = std::min(m_first, static_cast<int>(i));
+    m_last  = std::max(m_last,  static_cast<int>(i));
+}
+
+bool StreamHistogram::ExportCsv(const HistogramSnapshot& h, DmmUnit unit,
+                                const std::string& filePath)
+{
+    FILE* fp = fopen(filePath.c_str(), "w");
+    if (!fp) return false;
+
+    const double scale = DmmUnitScale(unit);
+    const char*  text  = DmmUnitText(unit);
+    fprintf(fp, "BinLow,BinHigh,Count,Units\n");
+    for (int i = 0; i < HistogramSnapshot::kBins; ++i)
+    {
+        if (h.counts[static_cast<size_t>(i)] == 0) continue;
+        fprintf(fp, "%.9g,%.9g,%llu,%s\n",
+                h.BinLow(i) / scale, h.BinLow(i + 1) / scale,
+                static_cast<unsigned long long>(h.counts[static_cast<size_t>(i)]), text);
+    }
+    bool ok = !ferror(fp);
+    return fclose(fp) == 0 && ok;
+}
@@ -0,0 +1,67 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — StreamHistogram.h
+//  Fixed-memory streaming histogram.
+//
+//  kBins counters on a grid of width w: bin i counts values in
+//  [(base + i) * w, (base + i + 1) * w).  The width starts at
+//  the meter's resolution (the last digit of the first reading)
+//  and, when a value falls outside the bins and the occupied
+//  range cannot simply be shifted to make room, adjacent bins
+//  are merged: w steps 1 → 2 → 10 → 20 → 100 ... × 10^n, so bin
+//  edges stay on round numbers and each merge is exact.
+//
+//  Add() is O(1) except for the rare shift / merge, which is
+//  O(kBins) and in place; nothing is allocated per sample.
+//  Not thread-safe: StatsEngine owns one under its own lock.
+// ============================================================
+#include <array>
+#include <cstdint>
+#include <string>
+#include "DmmParser.h"
+
+struct HistogramSnapshot
+{
+    static constexpr int kBins = 120;
+
+    double   width = 0.0;       // bin width; 0 until the first value
+    int64_t  base  = 0;         // grid index of bin 0
+    uint64_t total = 0;         // values counted
+    std::array<uint64_t, kBins> counts{};
+
+    double BinLow(int i) const { return static_cast<double>(base + i) * width; }
+};
+
+class StreamHistogram
+{
+public:
+    static constexpr int kBins = HistogramSnapshot::kBins;
+
+    void Reset();
+
+    // 'resolution' is the step of the reading's last digit in the
+    // value's units (e.g. 0.001 for "3.141 V"); used for the first value.
+    void Add(double x, double resolution);
+
+    const HistogramSnapshot& Data() const { return m_data; }
+
+    // Resolution of a sample's value token, in base units
+    // ("3.141" mV → 1e-6).  0 if it has no number.
+    static double Resolution(const DmmSample& s);
+
+    // "BinLow,BinHigh,Count,Units" rows, in the given display unit.
+    static bool ExportCsv(const HistogramSnapshot& h, DmmUnit unit,
+                          const std::string& filePath);
+
+private:
+    int64_t GridIndex(double x) const;
+    bool    Rebase(int64_t lo, int64_t hi);     // fit [lo, hi]; false if too wide
+    void    Widen();
+
+    HistogramSnapshot m_data;
+    int      m_mant = 1;                        // width = m_mant * 10^m_exp
+    int      m_exp  = 0;
+    int      m_first = 0;                       // occupied bins [m_first, m_last]
+    int      m_last  = -1;
+    std::array<uint64_t, kBins> m_scratch{};
+};
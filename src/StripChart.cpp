@@ -0,0 +1,356 @@
+// ============================================================
+//  Protek506Logger — StripChart.cpp
+// ============================================================
+#include "StripChart.h"
+#include <wx/dcbuffer.h>
+#include <wx/settings.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const int64_t MIN_SPAN_US = 2LL * 1000000;                  // 2 s
+static const int64_t MAX_SPAN_US = 31LL * 24 * 3600 * 1000000;     // 31 days
+static const double  ZOOM_STEP   = 1.25;                           // per wheel notch
+
+// "45 s", "2 min", "1.5 h", "3 d"
+static wxString FormatSpan(int64_t us)
+{
+    double s = us / 1e6;
+    if (s < 120)        return wxString::Format("%.0f s",   s);
+    if (s < 2 * 3600)   return wxString::Format("%.3g min", s / 60);
+    if (s < 2 * 86400)  return wxString::Format("%.3g h",   s / 3600);
+    return                     wxString::Format("%.3g d",   s / 86400);
+}
+
+StripChart::StripChart(wxWindow* parent, wxWindowID id)
+    : wxPanel(parent, id, wxDefaultPosition, wxSize(-1, 140),
+              wxFULL_REPAINT_ON_RESIZE)
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);     // needed for wxAutoBufferedPaintDC
+    SetMinSize(wxSize(-1, 120));
+
+    Bind(wxEVT_PAINT,              &StripChart::OnPaint,       this);
+    Bind(wxEVT_SIZE,               &StripChart::OnSize,        this);
+    Bind(wxEVT_MOUSEWHEEL,         &StripChart::OnMouseWheel,  this);
+    Bind(wxEVT_LEFT_DOWN,          &StripChart::OnLeftDown,    this);
+    Bind(wxEVT_LEFT_UP,            &StripChart::OnLeftUp,      this);
+    Bind(wxEVT_MOTION,             &StripChart::OnMotion,      this);
+    Bind(wxEVT_LEFT_DCLICK,        &StripChart::OnDoubleClick, this);
+    Bind(wxEVT_MOUSE_CAPTURE_LOST, &StripChart::OnCaptureLost, this);
+
+    SetToolTip("Wheel: zoom   Drag: pan   Double-click: follow live");
+}
+
+// ----------------------------------------------------------------
+// Data
+// ----------------------------------------------------------------
+void StripChart::SetCapacity(size_t capacity)
+{
+    m_history.SetRawCapacity(capacity);
+    Clear();
+}
+
+void StripChart::Clear()
+{
+    m_history.Clear();
+    m_mode     = DmmMode::Unknown;
+    m_base     = DmmUnit::None;
+    m_unit     = DmmUnit::None;
+    m_periodUs = 0;
+    m_follow   = true;
+    m_pending  = false;
+    Refresh(false);
+}
+
+void StripChart::Append(const DmmSample& s)
+{
+    // Same rule as the stats panel: mode + base unit is one series, so
+    // autoranging V ↔ mV continues the trace.  Only a number can change
+    // it: OL and the like carry no unit, and go into the current series
+    // as gaps.
+    if (s.kind == DmmValueKind::Numeric)
+    {
+        DmmUnit base = DmmBaseUnit(s.unit);
+        if (s.mode != m_mode || base != m_base)
+        {
+            Clear();
+            m_mode = s.mode;
+            m_base = base;
+        }
+        m_unit = s.unit;
+    }
+
+    if (!m_history.Empty())
+    {
+        int64_t delta = s.monoUs - m_history.LastUs();
+        if (delta < 0) return;                  // steady clock; cannot happen
+        m_periodUs = m_periodUs == 0 ? delta : (m_periodUs * 7 + delta) / 8;
+    }
+
+    // The same number the stats panel accumulates
+    m_history.Append(s.monoUs, s.kind == DmmValueKind::Numeric
+                                   ? s.scaled
+                                   : std::numeric_limits<double>::quiet_NaN());
+    m_pending = true;
+}
+
+void StripChart::Flush()
+{
+    if (!m_pending) return;
+    m_pending = false;
+    // New samples land at the right edge; a paused view does not move.
+    if (m_follow && IsShownOnScreen())
+        Refresh(false);
+}
+
+// ----------------------------------------------------------------
+// Decimation
+// ----------------------------------------------------------------
+int64_t StripChart::ViewEndUs() const
+{
+    return m_follow ? m_history.LastUs() : m_endUs;
+}
+
+void StripChart::AddToColumn(int c, int64_t firstUs, int64_t lastUs,
+                             double mn, double mx, double first, double last,
+                             bool& pendingBreak)
+{
+    Column& col = m_cols[c];
+    if (!col.used)
+    {
+        col.used        = true;
+        col.minValue    = mn;
+        col.maxValue    = mx;
+        col.first       = first;
+        col.firstUs     = firstUs;
+        col.breakBefore = pendingBreak;
+    }
+    else
+    {
+        if (mn < col.minValue) col.minValue = mn;
+        if (mx > col.maxValue) col.maxValue = mx;
+    }
+    col.last     = last;
+    col.lastUs   = lastUs;
+    pendingBreak = false;
+}
+
+int64_t StripChart::Decimate(int64_t t0, int width)
+{
+    Column empty = {};
+    m_cols.assign(static_cast<size_t>(std::max(width, 0)), empty);
+    if (m_history.Empty() || width <= 0) return 0;
+
+    const int64_t t1 = t0 + m_spanUs;
+    auto colOf = [t0, width, this](int64_t t) {
+        if (t < t0) return 0;
+        int c = static_cast<int>((t - t0) * width / m_spanUs);
+        return c < width ? c : width - 1;
+    };
+
+    // About two items per pixel column, from the finest level that
+    // still reaches back to t0.
+    bool pendingBreak = false;
+    int  level = m_history.PickLevel(t0, t1, static_cast<size_t>(width) * 2);
+    if (level == HistoryPyramid::kRaw)
+    {
+        m_history.ForEachRaw(t0, t1, [&](const HistoryPoint& p) {
+            if (std::isnan(p.value)) { pendingBreak = true; return; }
+            AddToColumn(colOf(p.monoUs), p.monoUs, p.monoUs,
+                        p.value, p.value, p.value, p.value, pendingBreak);
+        });
+        return 0;
+    }
+
+    const int64_t bucketUs = HistoryPyramid::kLevelUs[level];
+    m_history.ForEachBucket(level, t0, t1, [&](const HistoryBucket& b) {
+        if (b.count > 0)
+        {
+            double mean = b.Mean();
+            AddToColumn(colOf(b.startUs), b.startUs, b.startUs + bucketUs - 1,
+                        b.minValue, b.maxValue, mean, mean, pendingBreak);
+        }
+        if (b.other > 0) pendingBreak = true;
+    });
+    return bucketUs;
+}
+
+// ----------------------------------------------------------------
+// Painting
+// ----------------------------------------------------------------
+wxRect StripChart::PlotRect() const
+{
+    wxSize sz = GetClientSize();
+    int footer = GetTextExtent("0").GetHeight() + 4;
+    return wxRect(4, 4, std::max(sz.GetWidth() - 8, 1),
+                  std::max(sz.GetHeight() - 8 - footer, 1));
+}
+
+void StripChart::OnPaint(wxPaintEvent&)
+{
+    wxAutoBufferedPaintDC dc(this);
+    wxColour bg   = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW);
+    wxColour fg   = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT);
+    wxColour grey = wxSystemSettings::GetColour(wxSYS_COLOUR_GRAYTEXT);
+    dc.SetBackground(wxBrush(bg));
+    dc.Clear();
+    dc.SetFont(GetFont());
+
+    wxRect r = PlotRect();
+    dc.SetPen(wxPen(grey));
+    dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    dc.DrawRectangle(r);
+
+    // Footer: span and follow state
+    int footerY = r.GetBottom() + 3;
+    dc.SetTextForeground(grey);
+    dc.DrawText(FormatSpan(m_spanUs), r.GetLeft(), footerY);
+    wxString state = m_follow ? wxString("live")
+                              : wxString("paused - double-click to follow");
+    dc.DrawText(state, r.GetRight() - dc.GetTextExtent(state).GetWidth(), footerY);
+
+    const int64_t t0     = ViewEndUs() - m_spanUs;
+    const int64_t itemUs = Decimate(t0, r.GetWidth());
+
+    // Vertical range: what is in view, in the range the meter is on now
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
+    for (const Column& c : m_cols)
+    {
+        if (!c.used) continue;
+        lo = std::min(lo, c.minValue);
+        hi = std::max(hi, c.maxValue);
+    }
+    if (lo > hi)
+    {
+        dc.DrawText("No numeric readings in view", r.GetLeft() + 6, r.GetTop() + 4);
+        return;
+    }
+    const double scale = DmmUnitScale(m_unit);
+    lo /= scale;
+    hi /= scale;
+    double pad = hi > lo ? (hi - lo) * 0.05
+                         : (hi != 0.0 ? std::fabs(hi) * 0.05 : 1.0);
+    lo -= pad;
+    hi += pad;
+
+    const int plotH = r.GetHeight() - 1;
+    auto yOf = [&](double base) {
+        return r.GetTop() + plotH -
+               static_cast<int>(std::lround((base / scale - lo) * plotH / (hi - lo)));
+    };
+
+    // Grid: four bands, value labels inside the left edge
+    const char* unitText = DmmUnitText(m_unit);
+    dc.SetPen(wxPen(grey, 1, wxPENSTYLE_DOT));
+    for (int k = 1; k <= 3; ++k)
+    {
+        int y = r.GetTop() + plotH * k / 4;
+        dc.DrawLine(r.GetLeft() + 1, y, r.GetRight(), y);
+    }
+    dc.SetTextForeground(fg);
+    for (int k = 0; k <= 4; k += 2)
+    {
+        double   v = hi - (hi - lo) * k / 4;
+        wxString label = wxString::Format("%.6g ", v) + wxString::FromUTF8(unitText);
+        int th = dc.GetTextExtent(label).GetHeight();
+        int y  = r.GetTop() + plotH * k / 4 - th / 2;
+        y = std::max(r.GetTop() + 1, std::min(y, r.GetBottom() - th));
+        dc.DrawText(label, r.GetLeft() + 4, y);
+    }
+
+    // Trace: a min-max bar per column, joined to the previous column
+    // unless a gap or a non-numeric reading lies between them.
+    const int64_t gapUs = std::max<int64_t>(std::max<int64_t>(1000000, m_periodUs * 4),
+                                            itemUs * 2);
+    dc.SetPen(wxPen(wxColour(20, 160, 20)));
+    int prev = -1;
+    for (int c = 0; c < static_cast<int>(m_cols.size()); ++c)
+    {
+        const Column& col = m_cols[c];
+        if (!col.used) continue;
+        int x = r.GetLeft() + c;
+        if (prev >= 0 && !col.breakBefore &&
+            col.firstUs - m_cols[prev].lastUs <= gapUs)
+            dc.DrawLine(r.GetLeft() + prev, yOf(m_cols[prev].last), x, yOf(col.first));
+        dc.DrawLine(x, yOf(col.maxValue), x, yOf(col.minValue) + 1);
+        prev = c;
+    }
+}
+
+void StripChart::OnSize(wxSizeEvent& evt)
+{
+    Refresh(false);
+    evt.Skip();
+}
+
+// ----------------------------------------------------------------
+// Mouse
+// ----------------------------------------------------------------
+void StripChart::OnMouseWheel(wxMouseEvent& evt)
+{
+    int delta = evt.GetWheelDelta() > 0 ? evt.GetWheelDelta() : 120;
+    double notches = static_cast<double>(evt.GetWheelRotation()) / delta;
+    if (notches == 0.0) return;
+
+    int64_t span = static_cast<int64_t>(m_spanUs * std::pow(ZOOM_STEP, -notches));
+    span = std::max(MIN_SPAN_US, std::min(span, MAX_SPAN_US));
+
+    if (!m_follow)
+    {
+        // Keep the time under the pointer where it is.
+        wxRect  r  = PlotRect();
+        double  fx = std::max(0.0, std::min(1.0,
+                         static_cast<double>(evt.GetX() - r.GetLeft()) / r.GetWidth()));
+        int64_t t0     = m_endUs - m_spanUs;
+        int64_t cursor = t0 + static_cast<int64_t>(fx * m_spanUs);
+        m_endUs = cursor - static_cast<int64_t>(fx * span) + span;
+    }
+    m_spanUs = span;
+    Refresh(false);
+}
+
+void StripChart::OnLeftDown(wxMouseEvent& evt)
+{
+    m_dragging  = true;
+    m_dragX     = evt.GetX();
+    m_dragEndUs = ViewEndUs();
+    if (!HasCapture()) CaptureMouse();
+}
+
+void StripChart::OnLeftUp(wxMouseEvent&)
+{
+    m_dragging = false;
+    if (HasCapture()) ReleaseMouse();
+}
+
+void StripChart::OnCaptureLost(wxMouseCaptureLostEvent&)
+{
+    m_dragging = false;
+}
+
+void StripChart::OnMotion(wxMouseEvent& evt)
+{
+    if (!m_dragging || !evt.LeftIsDown()) return;
+    int dx = evt.GetX() - m_dragX;
+    if (dx == 0) return;
+
+    int64_t end = m_dragEndUs - dx * m_spanUs / PlotRect().GetWidth();
+    // Dragged back up to the newest sample: follow it again.
+    if (!m_history.Empty() && end >= m_history.LastUs())
+    {
+        m_follow = true;
+    }
+    else
+    {
+        m_follow = false;
+        m_endUs  = end;
+    }
+    Refresh(false);
+}
+
+void StripChart::OnDoubleClick(wxMouseEvent&)
+{
+    m_follow = true;
+    Refresh(false);
+}
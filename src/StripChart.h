@@ -0,0 +1,92 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — StripChart.h
+//  Custom-drawn trend chart of the readings in the current
+//  mode / quantity.
+//
+//  Fed on the GUI thread from the drained reading batches, so
+//  it never touches the reader thread.  Values are kept in SI
+//  base units (DmmSample::scaled) and drawn in the range the
+//  meter is on now, like the stats panel.  A numeric reading in
+//  another mode or quantity starts a new series; OL and other
+//  non-numeric readings are gaps in the current one.
+//
+//  Drawing is min/max decimated: each pixel column shows the
+//  range of the samples that fall into it.  The series lives in
+//  a HistoryPyramid, and a paint reads whichever level covers
+//  the view in about two items per column — full-rate samples
+//  when zoomed in, 1 s ... 10 min buckets further out — so it
+//  costs about the chart's width however long the view is.
+//
+//  Mouse: wheel zooms the time axis around the pointer, drag
+//  pans, double-click returns to following the live value.
+// ============================================================
+#include <wx/wx.h>
+#include <cstdint>
+#include <vector>
+#include "DmmParser.h"
+#include "HistoryPyramid.h"
+
+class StripChart : public wxPanel
+{
+public:
+    static const size_t kDefaultCapacity = HistoryPyramid::kDefaultRawCapacity;
+
+    explicit StripChart(wxWindow* parent, wxWindowID id = wxID_ANY);
+
+    void Append(const DmmSample& s);
+    void Clear();
+
+    // Repaint if anything visible changed since the last call; called
+    // once per frame by the owner.
+    void Flush();
+
+    // Full-rate samples kept before only the bucket levels remain
+    void   SetCapacity(size_t capacity);      // clears the chart
+    size_t Capacity() const { return m_history.RawCapacity(); }
+
+    // The series behind the chart (base units), e.g. for range queries
+    const HistoryPyramid& History() const { return m_history; }
+
+private:
+    struct Column
+    {
+        double  minValue, maxValue, first, last;
+        int64_t firstUs, lastUs;
+        bool    used;
+        bool    breakBefore;    // an OL or similar precedes the first value
+    };
+
+    void    OnPaint(wxPaintEvent& evt);
+    void    OnSize(wxSizeEvent& evt);
+    void    OnMouseWheel(wxMouseEvent& evt);
+    void    OnLeftDown(wxMouseEvent& evt);
+    void    OnLeftUp(wxMouseEvent& evt);
+    void    OnMotion(wxMouseEvent& evt);
+    void    OnDoubleClick(wxMouseEvent& evt);
+    void    OnCaptureLost(wxMouseCaptureLostEvent& evt);
+
+    wxRect  PlotRect() const;
+    int64_t ViewEndUs() const;
+    int64_t Decimate(int64_t t0, int width);     // returns the item width
+    void    AddToColumn(int col, int64_t firstUs, int64_t lastUs,
+                        double mn, double mx, double first, double last,
+                        bool& pendingBreak);
+
+    HistoryPyramid m_history;                   // base units
+    DmmMode  m_mode       = DmmMode::Unknown;   // series context
+    DmmUnit  m_base       = DmmUnit::None;
+    DmmUnit  m_unit       = DmmUnit::None;      // display range (latest)
+    int64_t  m_periodUs   = 0;                  // smoothed sample spacing
+
+    // View
+    bool     m_follow     = true;
+    int64_t  m_spanUs     = 120LL * 1000000;    // visible time span
+    int64_t  m_endUs      = 0;                  // right edge when not following
+    bool     m_dragging   = false;
+    int      m_dragX      = 0;
+    int64_t  m_dragEndUs  = 0;
+    bool     m_pending    = false;              // appended since last Flush()
+
+    std::vector<Column> m_cols;                 // reused between paints
+};
@@ -0,0 +1,88 @@
+// ============================================================
+//  Protek506Logger — TimestampFormatter.cpp
+// ============================================================
+#include "TimestampFormatter.h"
+#include <charconv>
+#include <cstring>
+#include <ctime>
+
+static const char* const FORMAT_NAMES[] = { "tenths", "ms", "us" };
+
+/*static*/ const char* TimestampFormatter::FormatName(LogTimeFormat format)
+{
+    return FORMAT_NAMES[static_cast<int>(format)];
+}
+
+/*static*/ bool TimestampFormatter::FormatFromName(const std::string& name, LogTimeFormat& format)
+{
+    for (int i = 0; i < 3; ++i)
+        if (name == FORMAT_NAMES[i])
+        {
+            format = static_cast<LogTimeFormat>(i);
+            return true;
+        }
+    return false;
+}
+
+// Whole seconds and the microseconds past them (floored, so a time
+// before 1970 still has a fraction of 0..999999)
+void TimestampFormatter::Split(int64_t wallUs, int64_t& sec, int& micros)
+{
+    sec    = wallUs / 1000000;
+    micros = static_cast<int>(wallUs % 1000000);
+    if (micros < 0)
+    {
+        micros += 1000000;
+        --sec;
+    }
+    if (sec != m_sec)
+        Refresh(sec);
+}
+
+// The slow part, once per second: local date and HH:MM:SS
+void TimestampFormatter::Refresh(int64_t sec)
+{
+    std::time_t t = static_cast<std::time_t>(sec);
+    std::tm tm_local;
+#if defined(_WIN32) || defined(__WINDOWS__)
+    localtime_s(&tm_local, &t);
+#else
+    localtime_r(&t, &tm_local);
+#endif
+    if (std::strftime(m_date, sizeof(m_date), "%Y-%m-%d", &tm_local) != kDateLen)
+        memset(m_date, '0', kDateLen);      // out of strftime's 4-digit years
+    std::strftime(m_hms, sizeof(m_hms), "%H:%M:%S", &tm_local);
+    m_sec = sec;
+}
+
+size_t TimestampFormatter::Date(int64_t wallUs, char* out)
+{
+    int64_t sec;
+    int     micros;
+    Split(wallUs, sec, micros);
+    memcpy(out, m_date, kDateLen);
+    return kDateLen;
+}
+
+size_t TimestampFormatter::Time(int64_t wallUs, char* out)
+{
+    int64_t sec;
+    int     micros;
+    Split(wallUs, sec, micros);
+
+    int digits = 1, frac = micros / 100000;
+    if (m_format == LogTimeFormat::Millis)      { digits = 3; frac = micros / 1000; }
+    else if (m_format == LogTimeFormat::Micros) { digits = 6; frac = micros; }
+
+    memcpy(out, m_hms, 8);
+    out[8] = '.';
+
+    // Zero-padded: to_chars at the right, '0's before it
+    char* end = out + 9 + digits;
+    char  buf[8];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), frac);
+    size_t n = static_cast<size_t>(r.ptr - buf);
+    memset(out + 9, '0', static_cast<size_t>(digits) - n);
+    memcpy(end - n, buf, n);
+    return static_cast<size_t>(end - out);
+}
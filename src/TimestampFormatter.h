@@ -0,0 +1,62 @@
+#pragma once
+// ============================================================
+//  Protek506Logger — TimestampFormatter.h
+//  Date and time-of-day text for wall-clock timestamps, as the
+//  CSV log and the Reading Log table show them:
+//  "2026-02-26" and "15:30:45.3".
+//
+//  Readings arrive a few times a second, so nearly every call
+//  falls in the same second as the one before.  The date and
+//  the "HH:MM:SS" prefix (localtime_r + strftime) are worked
+//  out only when the second changes and kept; otherwise a call
+//  is two small copies and the fraction digits written with
+//  std::to_chars.  Output goes to the caller's buffer; nothing
+//  is allocated.
+//
+//  Not thread-safe: the cache belongs to one thread (the log
+//  writer's CsvLogger, the GUI's ReadingTable).
+// ============================================================
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Resolution of the time text ([Logging] TimeFormat for the CSV)
+enum class LogTimeFormat : uint8_t
+{
+    Tenths,         // 15:30:45.3       (the v1.4.0 format, default)
+    Millis,         // 15:30:45.123
+    Micros          // 15:30:45.123456
+};
+
+class TimestampFormatter
+{
+public:
+    static constexpr size_t kDateLen = 10;      // "2026-02-26"
+    static constexpr size_t kTimeMax = 15;      // "15:30:45.123456"
+
+    explicit TimestampFormatter(LogTimeFormat format = LogTimeFormat::Tenths)
+        : m_format(format) {}
+
+    void          SetFormat(LogTimeFormat format) { m_format = format; }
+    LogTimeFormat Format() const { return m_format; }
+
+    // Write the date (kDateLen chars) or the time (up to kTimeMax) of
+    // wallUs, µs since the epoch, in local time.  No terminating NUL;
+    // the length is returned.  The fraction is truncated, never
+    // rounded into the next second.
+    size_t Date(int64_t wallUs, char* out);
+    size_t Time(int64_t wallUs, char* out);
+
+    // "tenths", "ms", "us" (the INI and command-line spelling)
+    static const char* FormatName(LogTimeFormat format);
+    static bool        FormatFromName(const std::string& name, LogTimeFormat& format);
+
+private:
+    void Split(int64_t wallUs, int64_t& sec, int& micros);
+    void Refresh(int64_t sec);
+
+    LogTimeFormat m_format;
+    int64_t       m_sec = INT64_MIN;            // second the cache holds
+    char          m_date[kDateLen + 1] = {};    // +1: strftime's NUL
+    char          m_hms[9] = {};                // "HH:MM:SS" + NUL
+};
@@ -0,0 +1,182 @@
+// ============================================================
+//  Protek506Logger — p506tocsv.cpp
+//  Converts a binary session log (*.p506) or a saved history
+//  (*.p506h, File > Save History) to the CSV layout the logger
+//  writes (date, time, mode, reading, units, raw).
+//
+//  Usage: p506tocsv [-t fmt] <in.p506 | in.p506h> [out.csv]
+//         -t: time column as tenths (default), ms or us; the
+//         binary log keeps microseconds, so nothing is lost.
+//         A history keeps milliseconds and no raw line, so its
+//         raw column is empty.
+//         Without an output file the CSV goes to stdout.
+//         An existing output file is appended to, as by the
+//         logger itself.
+// ============================================================
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BinLogReader.h"
+#include "CsvLogger.h"
+#include "SeriesStore.h"
+#include "TimestampFormatter.h"
+
+static int Usage()
+{
+    fprintf(stderr,
+            "usage: p506tocsv [-t fmt] <in.p506 | in.p506h> [out.csv]\n"
+            "  -t fmt  time column: tenths (default), ms or us\n");
+    return 2;
+}
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+    std::string x(suffix);
+    return s.size() >= x.size() && s.compare(s.size() - x.size(), x.size(), x) == 0;
+}
+
+// Opened once the input has been, so a bad input leaves no empty CSV
+static bool OpenCsv(CsvLogger& out, const std::string& outPath, LogTimeFormat timeFormat)
+{
+    // Large batches: this is a bulk conversion, not a live log
+    LogFlushPolicy policy;
+    policy.everyRows = 0;
+    policy.everyMs   = 1000;
+
+    out.SetFlushPolicy(policy);
+    out.SetTimeFormat(timeFormat);
+    if (!out.Open(outPath))
+    {
+        fprintf(stderr, "p506tocsv: %s\n", out.LastError().c_str());
+        return false;
+    }
+    return true;
+}
+
+// A binary session log, record by record
+static int ConvertLog(const char* inPath, const std::string& outPath, LogTimeFormat timeFormat)
+{
+    BinLogReader in;
+    if (!in.Open(inPath))
+    {
+        fprintf(stderr, "p506tocsv: %s\n", in.LastError().c_str());
+        return 1;
+    }
+    CsvLogger out;
+    if (!OpenCsv(out, outPath, timeFormat))
+        return 1;
+
+    DmmSample s;
+    while (in.Next(s))
+    {
+        out.Write(s);
+        if (!out.WriteOk()) break;
+    }
+    out.Close();
+
+    if (!out.WriteOk())
+    {
+        fprintf(stderr, "p506tocsv: %s\n", out.LastError().c_str());
+        return 1;
+    }
+    if (!in.LastError().empty())
+    {
+        fprintf(stderr, "p506tocsv: %s\n", in.LastError().c_str());
+        return 1;
+    }
+    if (in.BadChunks() > 0)
+        fprintf(stderr, "p506tocsv: warning: %llu chunk(s) damaged or failed their checksum\n",
+                static_cast<unsigned long long>(in.BadChunks()));
+    if (in.Truncated())
+        fprintf(stderr, "p506tocsv: warning: file ends in a partial record (ignored)\n");
+    fprintf(stderr, "p506tocsv: %ld rows from %llu session(s)\n", out.RowCount(),
+            static_cast<unsigned long long>(in.Sessions()));
+    return 0;
+}
+
+// A saved SeriesStore, block by block.  The store keeps the value in
+// the block's unit and the kind of special readings, but not the line
+// as sent, so the reading column is the number re-printed.
+static int ConvertHistory(const char* inPath, const std::string& outPath, LogTimeFormat timeFormat)
+{
+    SeriesStore in;
+    if (!in.Load(inPath))
+    {
+        fprintf(stderr, "p506tocsv: %s\n", in.LastError().c_str());
+        return 1;
+    }
+    CsvLogger out;
+    if (!OpenCsv(out, outPath, timeFormat))
+        return 1;
+
+    TimestampFormatter fmt(timeFormat);
+    const int64_t wallOffsetUs = in.WallOffsetUs();
+    std::vector<SeriesPoint> points;
+    SeriesBlockInfo info;
+    for (size_t b = 0; b < in.BlockCount() && out.WriteOk(); ++b)
+    {
+        points.clear();
+        if (!in.BlockInfo(b, info) || !in.DecodeBlock(b, points))
+            break;
+        const std::string mode  = DmmModeName(info.mode);
+        const std::string units = DmmUnitText(info.unit);
+        for (const SeriesPoint& p : points)
+        {
+            char date[TimestampFormatter::kDateLen], time[TimestampFormatter::kTimeMax];
+            int64_t wallUs = p.monoUs + wallOffsetUs;
+            std::string d(date, fmt.Date(wallUs, date));
+            std::string t(time, fmt.Time(wallUs, time));
+
+            char value[32] = "";
+            if (p.kind != DmmValueKind::Numeric)
+            {
+                DmmSample special;
+                special.kind = p.kind;
+                int len = 0;
+                const char* text = DmmValueText(special, len);
+                snprintf(value, sizeof(value), "%.*s", len, text);
+            }
+            else if (!std::isnan(p.value))
+                snprintf(value, sizeof(value), "%.10g", p.value);
+
+            out.Write(d, t, mode, value,
+                      p.kind == DmmValueKind::Numeric ? units : std::string());
+            if (!out.WriteOk()) break;
+        }
+    }
+    out.Close();
+
+    if (!out.WriteOk())
+    {
+        fprintf(stderr, "p506tocsv: %s\n", out.LastError().c_str());
+        return 1;
+    }
+    fprintf(stderr, "p506tocsv: %ld rows from %llu block(s)\n", out.RowCount(),
+            static_cast<unsigned long long>(in.BlockCount()));
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    // No getopt: this tool is built on Windows too
+    LogTimeFormat timeFormat = LogTimeFormat::Tenths;
+    int arg = 1;
+    if (arg < argc && std::string(argv[arg]) == "-t")
+    {
+        if (arg + 1 >= argc || !TimestampFormatter::FormatFromName(argv[arg + 1], timeFormat))
+            return Usage();
+        arg += 2;
+    }
+    int files = argc - arg;
+    if (files < 1 || files > 2) return Usage();
+
+    std::string outPath = files == 2 ? argv[arg + 1] : "/dev/stdout";
+#ifdef _WIN32
+    if (files == 1) outPath = "CON";
+#endif
+
+    if (EndsWith(argv[arg], ".p506h"))
+        return ConvertHistory(argv[arg], outPath, timeFormat);
+    return ConvertLog(argv[arg], outPath, timeFormat);
+}
@@ -0,0 +1,328 @@
+// ============================================================
+//  Protek506Logger — protek506d.cpp
+//  Headless acquisition daemon: polls one or more Protek 506s
+//  and logs each to its own file, without wxWidgets (Linux).
+//
+//  Usage: protek506d [-i ms] [-s ms] [-t fmt] [-q] PORT=LOG [PORT=LOG ...]
+//
+//    -i ms   poll interval (default 200)
+//    -s ms   fdatasync each log at most this often (default 0,
+//            never; rows are still flushed every second)
+//    -t fmt  CSV time column: tenths (default), ms or us
+//    -q      no status line on stderr every minute
+//
+//  A LOG ending in ".p506" is written in the binary format (see
+//  p506tocsv), anything else as CSV.  All meters are polled
+//  from the one epoll thread of an AcquisitionEngine; each has
+//  its own AsyncLogWriter, which spills to a temporary file
+//  rather than stall the other meters behind a slow disk.  A
+//  meter that fails is reopened every few seconds.  SIGTERM /
+//  SIGINT stop the engine and drain every log before exit;
+//  SIGHUP prints the status line at once.
+// ============================================================
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include "AcquisitionEngine.h"
+#include "AsyncLogWriter.h"
+#include "TimestampFormatter.h"
+
+static const int REOPEN_DELAY_MS = 5000;
+static const int STATUS_EVERY_MS = 60000;
+
+using Clock = std::chrono::steady_clock;
+
+struct Meter
+{
+    std::string     port;
+    std::string     logPath;
+    AsyncLogWriter  log;
+    std::atomic<uint64_t> readings{0};
+
+    // Main thread only
+    int               portId  = -1;     // engine port; -1 while closed
+    Clock::time_point reopenAt;
+    uint64_t          missed  = 0;      // from ports already retired
+    uint64_t          garbled = 0;
+};
+
+// Engine port id -> meter, for the engine thread's reading callback,
+// and the ports the engine has dropped since the main thread looked.
+static std::mutex                               s_portsMutex;
+static std::map<int, Meter*>                    s_ports;
+static std::vector<std::pair<int, std::string>> s_downPorts;
+
+// Self-pipe: the signal handler writes the signal number, the engine
+// thread WAKE_PORT_DOWN.
+static int s_sigPipe[2] = { -1, -1 };
+static const unsigned char WAKE_PORT_DOWN = 0;
+
+static void OnSignal(int sig)
+{
+    int saved = errno;
+    unsigned char b = static_cast<unsigned char>(sig);
+    ssize_t n = ::write(s_sigPipe[1], &b, 1);
+    (void)n;
+    errno = saved;
+}
+
+static int Usage()
+{
+    fprintf(stderr,
+            "usage: protek506d [-i ms] [-s ms] [-t fmt] [-q] PORT=LOG [PORT=LOG ...]\n"
+            "  -i ms   poll interval (default 200)\n"
+            "  -s ms   fdatasync the logs at most this often (default 0 = never)\n"
+            "  -t fmt  CSV time column: tenths (default), ms or us\n"
+            "  -q      no status line every minute\n");
+    return 2;
+}
+
+// ----------------------------------------------------------------
+// Meters on the engine (main thread)
+// ----------------------------------------------------------------
+static void OpenMeter(AcquisitionEngine& engine, Meter& m, int pollMs)
+{
+    // Held across AddPort(): no reading can arrive before it is mapped
+    std::lock_guard<std::mutex> lock(s_portsMutex);
+    m.portId = engine.AddPort(m.port, pollMs);
+    if (m.portId < 0)
+    {
+        fprintf(stderr, "protek506d: %s: %s\n", m.port.c_str(), engine.LastError().c_str());
+        m.reopenAt = Clock::now() + std::chrono::milliseconds(REOPEN_DELAY_MS);
+        return;
+    }
+    s_ports[m.portId] = &m;
+}
+
+// Fold a dropped port's counters in and forget it, in one step on the
+// main thread, so PrintStatus() never counts them twice.
+static void RetirePort(AcquisitionEngine& engine, Meter& m)
+{
+    AcquisitionEngine::PortCounters c = engine.Counters(m.portId);
+    m.missed  += c.missed;
+    m.garbled += c.garbled;
+    engine.RemovePort(m.portId);
+    {
+        std::lock_guard<std::mutex> lock(s_portsMutex);
+        s_ports.erase(m.portId);
+    }
+    m.portId   = -1;
+    m.reopenAt = Clock::now() + std::chrono::milliseconds(REOPEN_DELAY_MS);
+}
+
+// Report and retire the ports the engine dropped.  False if the engine
+// itself failed (port id -1).
+static bool HandleDownPorts(AcquisitionEngine& engine,
+                            std::vector<std::unique_ptr<Meter>>& meters)
+{
+    std::vector<std::pair<int, std::string>> down;
+    {
+        std::lock_guard<std::mutex> lock(s_portsMutex);
+        down.swap(s_downPorts);
+    }
+    bool ok = true;
+    for (auto& d : down)
+    {
+        if (d.first < 0)
+        {
+            fprintf(stderr, "protek506d: %s\n", d.second.c_str());
+            ok = false;
+            continue;
+        }
+        for (auto& m : meters)
+            if (m->portId == d.first)
+            {
+                fprintf(stderr, "protek506d: %s: %s\n", m->port.c_str(), d.second.c_str());
+                RetirePort(engine, *m);
+            }
+    }
+    return ok;
+}
+
+static void PrintStatus(const AcquisitionEngine& engine,
+                        const std::vector<std::unique_ptr<Meter>>& meters)
+{
+    for (auto& mp : meters)
+    {
+        const Meter& m = *mp;
+        uint64_t missed  = m.missed;
+        uint64_t garbled = m.garbled;
+        if (m.portId >= 0)
+        {
+            AcquisitionEngine::PortCounters c = engine.Counters(m.portId);
+            missed  += c.missed;
+            garbled += c.garbled;
+        }
+        fprintf(stderr,
+                "protek506d: %s: %llu readings, %ld rows, %llu KiB -> %s"
+                " (missed %llu, garbled %llu, dropped %llu)\n",
+                m.port.c_str(),
+                static_cast<unsigned long long>(m.readings.load()),
+                m.log.RowCount(),
+                static_cast<unsigned long long>(m.log.BytesWritten() / 1024),
+                m.logPath.c_str(),
+                static_cast<unsigned long long>(missed),
+                static_cast<unsigned long long>(garbled),
+                static_cast<unsigned long long>(m.log.Dropped()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int  pollMs = 200;
+    int  syncMs = 0;
+    bool quiet  = false;
+    LogTimeFormat timeFormat = LogTimeFormat::Tenths;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:s:t:q")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i': pollMs = atoi(optarg); break;
+            case 's': syncMs = atoi(optarg); break;
+            case 't':
+                if (!TimestampFormatter::FormatFromName(optarg, timeFormat))
+                    return Usage();
+                break;
+            case 'q': quiet  = true;         break;
+            default:  return Usage();
+        }
+    }
+    if (optind >= argc || pollMs < 1 || syncMs < 0) return Usage();
+
+    // Rows are batched: a daemon has no window to keep in step with.
+    LogFlushPolicy policy;
+    policy.everyRows = 0;
+    policy.everyMs   = 1000;
+    policy.syncMs    = syncMs;
+
+    std::vector<std::unique_ptr<Meter>> meters;
+    for (int i = optind; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == arg.size())
+            return Usage();
+
+        auto m = std::make_unique<Meter>();
+        m->port    = arg.substr(0, eq);
+        m->logPath = arg.substr(eq + 1);
+        m->log.SetErrorHandler([port = m->port](const std::string& msg) {
+            fprintf(stderr, "protek506d: %s: log: %s\n", port.c_str(), msg.c_str());
+        });
+        m->log.SetTimeFormat(timeFormat);
+        // Spill, not Block: the engine thread is every meter's
+        if (!m->log.Open(m->logPath, policy, LogOverflow::Spill))
+        {
+            fprintf(stderr, "protek506d: %s: %s\n", m->logPath.c_str(),
+                    m->log.LastError().c_str());
+            return 1;
+        }
+        meters.push_back(std::move(m));
+    }
+
+    // Signals: handlers only write to the pipe; this thread reads it.
+    if (pipe(s_sigPipe) != 0)
+    {
+        fprintf(stderr, "protek506d: pipe: %s\n", strerror(errno));
+        return 1;
+    }
+    fcntl(s_sigPipe[1], F_SETFL, O_NONBLOCK);
+    struct sigaction sa = {};
+    sa.sa_handler = OnSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT,  &sa, nullptr);
+    sigaction(SIGHUP,  &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    AcquisitionEngine engine;
+    engine.SetReadingHandler([](int portId, const DmmSample& s) {
+        std::lock_guard<std::mutex> lock(s_portsMutex);
+        auto it = s_ports.find(portId);
+        if (it == s_ports.end()) return;
+        it->second->log.Push(s);
+        it->second->readings.fetch_add(1, std::memory_order_relaxed);
+    });
+    engine.SetErrorHandler([](int portId, const std::string& msg) {
+        {
+            std::lock_guard<std::mutex> lock(s_portsMutex);
+            s_downPorts.emplace_back(portId, msg);
+        }
+        unsigned char b = WAKE_PORT_DOWN;
+        ssize_t n = ::write(s_sigPipe[1], &b, 1);
+        (void)n;
+    });
+    if (!engine.Start())
+    {
+        fprintf(stderr, "protek506d: %s\n", engine.LastError().c_str());
+        return 1;
+    }
+    for (auto& m : meters)
+        OpenMeter(engine, *m, pollMs);
+
+    // Wait for a stop signal, printing the status line and reopening
+    // meters that dropped out on the way.
+    int rc = 0;
+    auto nextStatus = Clock::now() + std::chrono::milliseconds(STATUS_EVERY_MS);
+    for (;;)
+    {
+        Clock::time_point wake = nextStatus;
+        for (auto& m : meters)
+            if (m->portId < 0 && m->reopenAt < wake)
+                wake = m->reopenAt;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        wake - Clock::now()).count();
+        struct pollfd pfd = { s_sigPipe[0], POLLIN, 0 };
+        int n = ::poll(&pfd, 1, wait > 0 ? static_cast<int>(wait) : 0);
+        if (n < 0 && errno != EINTR) break;
+
+        unsigned char sig = 0;
+        if (n > 0 && ::read(s_sigPipe[0], &sig, 1) == 1)
+        {
+            if (sig == SIGTERM || sig == SIGINT) break;
+            if (sig == SIGHUP) PrintStatus(engine, meters);
+            if (sig == WAKE_PORT_DOWN && !HandleDownPorts(engine, meters))
+            {
+                rc = 1;
+                break;
+            }
+            continue;
+        }
+
+        Clock::time_point now = Clock::now();
+        for (auto& m : meters)
+            if (m->portId < 0 && now >= m->reopenAt)
+                OpenMeter(engine, *m, pollMs);
+        if (now >= nextStatus)
+        {
+            if (!quiet) PrintStatus(engine, meters);
+            nextStatus += std::chrono::milliseconds(STATUS_EVERY_MS);
+        }
+    }
+
+    // Shutdown: stop the engine (a reply in progress is cut off; nothing
+    // is delivered after Stop() returns), then drain and close every log.
+    engine.Stop();
+    for (auto& m : meters)
+    {
+        m->log.Close();
+        if (!m->log.LastError().empty()) rc = 1;
+    }
+    if (!quiet) PrintStatus(engine, meters);
+    return rc;
+}
@@ -0,0 +1,393 @@
+// ============================================================
+//  Protek506Logger — protek506sim.cpp
+//  Protek 506 simulator on a pseudo-terminal, for testing and
+//  benchmarking the acquisition path without a meter.
+//
+//  Usage: protek506sim [-n] [-m MODES] [-c count] [-x percent]
+//                      [-r ms] [-s seed] [-l link]
+//
+//    -n          no pacing: write each reply in one go, to see
+//                how fast the host side itself can go
+//    -m MODES    comma-separated mode words to cycle through
+//                (default: every word in DmmParser's s_modes)
+//    -c count    replies per mode before moving on (default 50)
+//    -x percent  share of special values — OL, SHORT, OPEN,
+//                GOOD, ---- where the mode has them (default 3)
+//    -r ms       delay between the trigger and the first byte
+//                of the reply (default 0)
+//    -s seed     random seed (default 1), for repeatable runs
+//    -l link     also make a symlink to the PTY at this path
+//
+//  The PTY's slave path is printed on stdout; point the logger,
+//  protek506d or a test at it.  Each '\n' read is answered with
+//  one line in the meter's format ("DC  3.141 V", "TEMP 0802 5 C",
+//  "BUZ SHORT" ...) terminated by CR.  Paced replies go out at
+//  the meter's 1200 baud 7N2 — ten bit times, 8.33 ms per byte —
+//  on absolute deadlines.  A trigger that arrives while a reply
+//  is being sent is answered after it, as one at a time.
+//  SIGINT / SIGTERM print the counters and exit.
+// ============================================================
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// 1200 baud, 1 start + 7 data + 2 stop bits
+static const int64_t BYTE_NS = 10LL * 1000000000LL / 1200;
+
+// Same words as s_modes in DmmParser.cpp
+static const char* const ALL_MODES[] =
+{
+    "DC", "AC", "RES", "BUZ", "DIO", "DIOD", "LOG", "FR", "CAP", "IND", "TEMP"
+};
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void OnSignal(int) { s_stop = 1; }
+
+static int64_t NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+static void SleepUntil(int64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec  = static_cast<time_t>(ns / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR && !s_stop)
+        ;
+}
+
+static int Usage()
+{
+    fprintf(stderr,
+            "usage: protek506sim [-n] [-m MODES] [-c count] [-x percent]\n"
+            "                    [-r ms] [-s seed] [-l link]\n"
+            "  -n          no pacing (reply at full speed instead of 1200 baud)\n"
+            "  -m MODES    comma-separated mode words to cycle (default: all)\n"
+            "  -c count    replies per mode (default 50)\n"
+            "  -x percent  share of special values, OL / SHORT / ... (default 3)\n"
+            "  -r ms       delay before each reply (default 0)\n"
+            "  -s seed     random seed (default 1)\n"
+            "  -l link     symlink to the PTY slave\n");
+    return 2;
+}
+
+// ----------------------------------------------------------------
+// Reading generator
+//
+// Each mode keeps a value that drifts in a slow random walk with a
+// little noise on top, and is formatted with the meter's ranges and
+// digits: 3 3/4 digits (up to 3999 counts) plus a range prefix.
+// ----------------------------------------------------------------
+class Generator
+{
+public:
+    explicit Generator(unsigned seed) : m_rng(seed) {}
+
+    void SetSpecialPercent(double pct) { m_special = pct / 100.0; }
+
+    std::string Line(const std::string& mode)
+    {
+        char buf[48];
+        const char* w = mode.c_str();
+        if      (mode == "DC")                   Volts(buf, sizeof(buf), w, 1.5,  true);
+        else if (mode == "AC")                   Volts(buf, sizeof(buf), w, 0.23, false);
+        else if (mode == "RES")                  Ohms(buf, sizeof(buf), w);
+        else if (mode == "BUZ")                  Continuity(buf, sizeof(buf), w);
+        else if (mode == "DIO" || mode == "DIOD") Diode(buf, sizeof(buf), w);
+        else if (mode == "LOG")                  Logic(buf, sizeof(buf), w);
+        else if (mode == "FR")                   Frequency(buf, sizeof(buf), w);
+        else if (mode == "CAP")                  Scaled(buf, sizeof(buf), w, 4.7e-6, "nF", 1e-9, "uF", 1e-6);
+        else if (mode == "IND")                  Scaled(buf, sizeof(buf), w, 2.2e-3, "mH", 1e-3, "H",  1.0);
+        else if (mode == "TEMP")                 Temperature(buf, sizeof(buf), w);
+        else                                     snprintf(buf, sizeof(buf), "%-3s 0.000", w);
+        return buf;
+    }
+
+private:
+    double Uniform(double a, double b) { return std::uniform_real_distribution<double>(a, b)(m_rng); }
+    bool   Chance(double p)            { return Uniform(0.0, 1.0) < p; }
+
+    // Random walk around 'nominal' (one value per mode word)
+    double Walk(const char* mode, double nominal, double relStep)
+    {
+        State& st = m_state[Hash(mode)];
+        if (st.nominal != nominal) { st.nominal = nominal; st.value = nominal; }
+        st.value += st.value * relStep * Uniform(-1.0, 1.0);
+        st.value += (nominal - st.value) * 0.01;            // drift back
+        return st.value * (1.0 + Uniform(-2e-4, 2e-4));     // noise
+    }
+
+    static size_t Hash(const char* s)
+    {
+        size_t h = 0;
+        while (*s) h = h * 31 + static_cast<unsigned char>(*s++);
+        return h % kStates;
+    }
+
+    // Format 'v' (in the display unit) with the meter's 4000 counts:
+    // as many decimals as fit, e.g. 3.141 / 31.41 / 314.1 / 3141
+    static void Counts(char* out, size_t n, double v)
+    {
+        double a = std::fabs(v);
+        int decimals = a < 4.0 ? 3 : a < 40.0 ? 2 : a < 400.0 ? 1 : 0;
+        snprintf(out, n, "%.*f", decimals, v);
+    }
+
+    void Volts(char* buf, size_t n, const char* w, double nominal, bool dc)
+    {
+        if (Chance(m_special)) { snprintf(buf, n, "%-3s OL", w); return; }
+        // DC swings through zero now and then; AC is a magnitude
+        double v = Walk(w, nominal, 0.002);
+        if (dc && Chance(0.01)) m_state[Hash(w)].value = -m_state[Hash(w)].value;
+        char num[24];
+        if (std::fabs(v) < 0.4) { Counts(num, sizeof(num), v * 1e3); snprintf(buf, n, "%-3s %s mV", w, num); }
+        else                    { Counts(num, sizeof(num), v);       snprintf(buf, n, "%-3s %s V",  w, num); }
+    }
+
+    void Ohms(char* buf, size_t n, const char* w)
+    {
+        if (Chance(m_special)) { snprintf(buf, n, "%-3s OL", w); return; }
+        double r = Walk(w, 4700.0, 0.001);
+        char num[24];
+        if      (r < 400.0)  { Counts(num, sizeof(num), r);       snprintf(buf, n, "%-3s %s OH",  w, num); }
+        else if (r < 4.0e5)  { Counts(num, sizeof(num), r / 1e3); snprintf(buf, n, "%-3s %s KOH", w, num); }
+        else                 { Counts(num, sizeof(num), r / 1e6); snprintf(buf, n, "%-3s %s MOH", w, num); }
+    }
+
+    void Continuity(char* buf, size_t n, const char* w)
+    {
+        // Mostly a resistance, SHORT / OPEN as the probe touches / lifts
+        if (Chance(m_special * 4))
+        {
+            snprintf(buf, n, "%-3s %s", w, Chance(0.5) ? "SHORT" : "OPEN");
+            return;
+        }
+        char num[24];
+        Counts(num, sizeof(num), Walk(w, 12.0, 0.01));
+        snprintf(buf, n, "%-3s %s OH", w, num);
+    }
+
+    void Diode(char* buf, size_t n, const char* w)
+    {
+        if (Chance(m_special))
+        {
+            snprintf(buf, n, "%-3s %s", w, Chance(0.5) ? "OL" : "GOOD");
+            return;
+        }
+        char num[24];
+        Counts(num, sizeof(num), Walk(w, 0.612, 0.0005));
+        snprintf(buf, n, "%-3s %s V", w, num);
+    }
+
+    void Logic(char* buf, size_t n, const char* w)
+    {
+        if (Chance(m_special)) { snprintf(buf, n, "%-3s ----", w); return; }
+        snprintf(buf, n, "%-3s %s", w, Chance(0.5) ? "HIGH" : "LOW");
+    }
+
+    void Frequency(char* buf, size_t n, const char* w)
+    {
+        double f = Walk(w, 1000.0, 0.0005);
+        char num[24];
+        if      (f < 4000.0) { Counts(num, sizeof(num), f);       snprintf(buf, n, "%-3s %s Hz",  w, num); }
+        else if (f < 4.0e6)  { Counts(num, sizeof(num), f / 1e3); snprintf(buf, n, "%-3s %s kHz", w, num); }
+        else                 { Counts(num, sizeof(num), f / 1e6); snprintf(buf, n, "%-3s %s MHz", w, num); }
+    }
+
+    // Two ranges: 'lo' unit below 4000 counts of it, 'hi' unit above
+    void Scaled(char* buf, size_t n, const char* w, double nominal,
+                const char* lo, double loScale, const char* hi, double hiScale)
+    {
+        if (Chance(m_special)) { snprintf(buf, n, "%-3s OL", w); return; }
+        double v = Walk(w, nominal, 0.001);
+        char num[24];
+        if (v / loScale < 4000.0) { Counts(num, sizeof(num), v / loScale); snprintf(buf, n, "%-3s %s %s", w, num, lo); }
+        else                      { Counts(num, sizeof(num), v / hiScale); snprintf(buf, n, "%-3s %s %s", w, num, hi); }
+    }
+
+    // "TEMP 0802 5 C": four integer digits, a space for the point
+    void Temperature(char* buf, size_t n, const char* w)
+    {
+        if (Chance(m_special)) { snprintf(buf, n, "%-3s OL", w); return; }
+        double t = Walk(w, 23.5, 0.0005);
+        long   d = std::lround(t * 10.0);
+        snprintf(buf, n, "%-3s %s%04ld %ld C", w, d < 0 ? "-" : "",
+                 std::labs(d) / 10, std::labs(d) % 10);
+    }
+
+    struct State { double nominal = 0.0; double value = 0.0; };
+    static const size_t kStates = 31;
+
+    std::mt19937 m_rng;
+    double       m_special = 0.03;
+    State        m_state[kStates];
+};
+
+int main(int argc, char** argv)
+{
+    bool        paced    = true;
+    int         perMode  = 50;
+    double      special  = 3.0;
+    int         delayMs  = 0;
+    unsigned    seed     = 1;
+    std::string link;
+    std::vector<std::string> modes(std::begin(ALL_MODES), std::end(ALL_MODES));
+
+    int opt;
+    while ((opt = getopt(argc, argv, "nm:c:x:r:s:l:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': paced   = false;                                  break;
+            case 'c': perMode = atoi(optarg);                           break;
+            case 'x': special = atof(optarg);                           break;
+            case 'r': delayMs = atoi(optarg);                           break;
+            case 's': seed    = static_cast<unsigned>(strtoul(optarg, nullptr, 10)); break;
+            case 'l': link    = optarg;                                 break;
+            case 'm':
+            {
+                modes.clear();
+                std::string list = optarg;
+                for (size_t i = 0; i <= list.size(); )
+                {
+                    size_t j = list.find(',', i);
+                    if (j == std::string::npos) j = list.size();
+                    if (j > i) modes.push_back(list.substr(i, j - i));
+                    i = j + 1;
+                }
+                break;
+            }
+            default:  return Usage();
+        }
+    }
+    if (optind != argc || modes.empty() || perMode < 1 || delayMs < 0 ||
+        special < 0 || special > 100)
+        return Usage();
+
+    // ---- PTY ----
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        fprintf(stderr, "protek506sim: cannot create a PTY: %s\n", strerror(errno));
+        return 1;
+    }
+    const char* slaveName = ptsname(master);
+    std::string slave = slaveName ? slaveName : "";
+
+    // Hold the slave open ourselves, in raw mode: the master then never
+    // sees a hangup between clients, and a client that does not set
+    // the line up itself still gets the bytes unchanged.
+    int hold = open(slave.c_str(), O_RDWR | O_NOCTTY);
+    if (hold >= 0)
+    {
+        struct termios tio;
+        if (tcgetattr(hold, &tio) == 0)
+        {
+            cfmakeraw(&tio);
+            tcsetattr(hold, TCSANOW, &tio);
+        }
+    }
+
+    if (!link.empty())
+    {
+        unlink(link.c_str());
+        if (symlink(slave.c_str(), link.c_str()) != 0)
+            fprintf(stderr, "protek506sim: symlink %s: %s\n", link.c_str(), strerror(errno));
+    }
+    printf("%s\n", slave.c_str());
+    fflush(stdout);
+
+    struct sigaction sa = {};
+    sa.sa_handler = OnSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    // ---- Trigger / reply loop ----
+    Generator gen(seed);
+    gen.SetSpecialPercent(special);
+
+    unsigned long long triggers = 0, bytes = 0;
+    size_t  modeIndex = 0;
+    int     inMode    = 0;
+    int64_t start     = NowNs();
+    int64_t lineFree  = start;          // when the wire is idle again
+
+    while (!s_stop)
+    {
+        struct pollfd pfd = { master, POLLIN, 0 };
+        int n = ::poll(&pfd, 1, 200);
+        if (n < 0 && errno != EINTR) break;
+        if (n <= 0) continue;
+
+        char in[256];
+        ssize_t got = ::read(master, in, sizeof(in));
+        if (got <= 0)
+        {
+            if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EIO)) continue;
+            break;
+        }
+
+        for (ssize_t i = 0; i < got && !s_stop; ++i)
+        {
+            if (in[i] != '\n') continue;
+            ++triggers;
+
+            std::string line = gen.Line(modes[modeIndex]) + "\r";
+            if (++inMode >= perMode)
+            {
+                inMode    = 0;
+                modeIndex = (modeIndex + 1) % modes.size();
+            }
+
+            int64_t now = NowNs();
+            if (delayMs > 0)
+                SleepUntil(now + static_cast<int64_t>(delayMs) * 1000000);
+
+            if (!paced)
+            {
+                ssize_t w = ::write(master, line.data(), line.size());
+                if (w > 0) bytes += static_cast<unsigned long long>(w);
+                continue;
+            }
+
+            // One byte per 10 bit times, on absolute deadlines, never
+            // earlier than the end of the previous reply.  Like a UART,
+            // a byte is handed over once its stop bits are out.
+            int64_t t = std::max(NowNs(), lineFree);
+            for (char c : line)
+            {
+                t += BYTE_NS;
+                SleepUntil(t);
+                if (s_stop) break;
+                if (::write(master, &c, 1) == 1) ++bytes;
+            }
+            lineFree = t;
+        }
+    }
+
+    double secs = (NowNs() - start) / 1e9;
+    fprintf(stderr, "protek506sim: %llu triggers, %llu bytes in %.1f s (%.0f replies/s)\n",
+            triggers, bytes, secs, secs > 0 ? triggers / secs : 0.0);
+
+    if (!link.empty()) unlink(link.c_str());
+    if (hold >= 0) close(hold);
+    close(master);
+    return 0;
+}